@@ -1,5 +1,5 @@
 param(
-    [ValidateSet("console", "raylib", "all")]
+    [ValidateSet("console", "raylib", "bookgen", "all")]
     [string]$Target = "all"
 )
 
@@ -38,8 +38,18 @@ function Build-Raylib {
     }
 }
 
+function Build-Bookgen {
+    Write-Host "Building opening book builder..." -ForegroundColor Cyan
+    g++ -std=c++17 -O2 "$SrcDir\bookgen.cpp" -o "$OutDir\bookgen.exe" `
+        -static -static-libgcc -static-libstdc++
+    if ($LASTEXITCODE -eq 0) {
+        Write-Host "Bookgen build success: bin\bookgen.exe" -ForegroundColor Green
+    }
+}
+
 switch ($Target) {
     "console" { Build-Console }
     "raylib"  { Build-Raylib }
+    "bookgen" { Build-Bookgen }
     "all"     { Build-Console; Build-Raylib }
 }
@@ -0,0 +1,110 @@
+#include "headers/ai.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <unordered_set>
+#include <vector>
+
+// Opening book builder
+// Searches every position the AI (white) can face in the first moves of a
+// game and writes the book that OpeningBook maps at startup. The user's first
+// stone goes anywhere within two cells of the centre, later replies are the
+// user's best few candidates; symmetric positions are searched once.
+//
+// Usage: bookgen [output] [stones] [replies] [milliseconds]
+//   output        book file (default BOOK_PATH)
+//   stones        deepest position searched, in stones on the board (default 7)
+//   replies       user replies followed from each book move (default 3)
+//   milliseconds  search time per position (default 2000)
+
+using Book = OpeningBook<BOARD_SIZE>;
+
+class BookBuilder {
+private:
+    AI<BOARD_SIZE> ai;
+    int maxStones, replies, milliseconds;
+    std::vector<Book::Record> records;
+    std::unordered_set<uint64_t> seen;
+
+    // The AI to move in `board`: search it, then follow the user's best replies
+    void expand(Board<BOARD_SIZE> &board) {
+        int symmetry;
+        uint64_t key = Book::canonicalKey(board, symmetry);
+        if (!seen.insert(key).second)
+            return;
+
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(milliseconds);
+        auto move = Board<BOARD_SIZE>::toMove(ai.getBestMove(board, deadline));
+        int score = ai.getLastScore();
+        records.push_back({key, Book::transform(move, symmetry), 1, score});
+        std::cout << "\r" << records.size() << " positions" << std::flush;
+
+        // decided positions need no book
+        if (score >= PredefinedScore::WIN || score <= PredefinedScore::LOSE)
+            return;
+
+        board.makeMove(move, Role::BOT);
+        if (board.getStoneCount() < maxStones) {
+            auto candidates = board.getSortedCandidates(Role::USER);
+            for (int i = 0; i < candidates.size() && i < replies; ++i) {
+                board.makeMove(candidates[i], Role::USER);
+                if (board.checkWinner(candidates[i]) == Role::EMPTY)
+                    expand(board);
+                board.undoMove(candidates[i]);
+            }
+        }
+        board.undoMove(move);
+    }
+
+public:
+    BookBuilder(int maxStones, int replies, int milliseconds)
+        : maxStones(maxStones), replies(replies), milliseconds(milliseconds) {
+        // search from scratch, not from an older book
+        ai.setBook(nullptr);
+    }
+
+    void build() {
+        const int centre = BOARD_SIZE / 2;
+        for (int x = centre - 2; x <= centre + 2; ++x)
+            for (int y = centre - 2; y <= centre + 2; ++y) {
+                Board<BOARD_SIZE> board;
+                board.makeMove(Point(x, y), Role::USER);
+                expand(board);
+            }
+        std::cout << std::endl;
+    }
+
+    bool write(const char *path) {
+        std::sort(records.begin(), records.end(),
+                  [](const Book::Record &a, const Book::Record &b) { return a.key < b.key; });
+
+        Book::Header header = {};
+        std::copy(Book::MAGIC, Book::MAGIC + sizeof(Book::MAGIC), header.magic);
+        header.boardSize = BOARD_SIZE;
+        header.count = static_cast<uint32_t>(records.size());
+
+        std::ofstream out(path, std::ios::binary);
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char *>(records.data()), records.size() * sizeof(Book::Record));
+        return static_cast<bool>(out);
+    }
+};
+
+int main(int argc, char **argv) {
+    const char *path = argc > 1 ? argv[1] : BOOK_PATH;
+    int stones = argc > 2 ? atoi(argv[2]) : 7;
+    int replies = argc > 3 ? atoi(argv[3]) : 3;
+    int milliseconds = argc > 4 ? atoi(argv[4]) : 2000;
+
+    BookBuilder builder(stones, replies, milliseconds);
+    builder.build();
+    if (!builder.write(path)) {
+        std::cerr << "Cannot write " << path << std::endl;
+        return 1;
+    }
+    std::cout << "Book written to " << path << std::endl;
+    return 0;
+}
@@ -1,12 +1,18 @@
 #include "headers/ai.h"
+#include "headers/mcts.h"
 #include <iostream>
 #include <string>
 #include <limits>
+#include <chrono>
+#include <memory>
 
 class ConsoleGame {
 private:
-    Board board;
-    AI ai;
+    Board<BOARD_SIZE> board;
+    Engine engine;
+    AI<BOARD_SIZE> ai;
+    // only built for --mcts: its node pool is large
+    std::unique_ptr<MCTS<BOARD_SIZE>> mcts;
 
     void printBoard(Point lastMove) const {
         std::cout << "\033[2J\033[H";
@@ -41,6 +47,12 @@ private:
     }
 
 public:
+    explicit ConsoleGame(Engine engine = Engine::ALPHA_BETA) : engine(engine) {
+        ai.setSolvedStore(SOLVED_PATH);
+        if (engine == Engine::MCTS)
+            mcts.reset(new MCTS<BOARD_SIZE>());
+    }
+
     void run() {
         printBoard(Point(-1, -1));
 
@@ -77,7 +89,9 @@ public:
             }
 
             std::cout << "AI is thinking..." << std::endl;
-            Point aiMove = ai.getBestMove(board);
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(SEARCH_TIME_MS);
+            Point aiMove = engine == Engine::MCTS ? mcts->getBestMove(board, deadline)
+                                                  : ai.getBestMove(board, deadline);
             board.makeMove(aiMove, Role::BOT);
             printBoard(aiMove);
 
@@ -98,8 +112,10 @@ public:
     }
 };
 
-int main() {
-    ConsoleGame game;
+int main(int argc, char **argv) {
+    // --mcts plays the Monte Carlo engine instead of the alpha-beta search
+    Engine engine = argc > 1 && std::string(argv[1]) == "--mcts" ? Engine::MCTS : Engine::ALPHA_BETA;
+    ConsoleGame game(engine);
     game.run();
     return 0;
 }
@@ -1,9 +1,14 @@
 #include "headers/ai.h"
+#include "headers/mcts.h"
 #include "raylib/raylib.h"
 #include <string>
 #include <thread>
 #include <atomic>
 #include <future>
+#include <functional>
+#include <memory>
+#include <vector>
+#include <algorithm>
 #include <cmath>
 
 // Layout Constants
@@ -30,8 +35,8 @@ const Color STAR_COLOR = { 140, 130, 115, 255 };      // Star points
 
 class RaylibGame {
 private:
-    Board board;
-    AI ai;
+    Board<BOARD_SIZE> board;
+    Engine engine;
     Point lastMove;
     bool gameOver = false;
     std::string message;
@@ -40,6 +45,16 @@ private:
     std::atomic<bool> aiThinking{false};
     std::future<Point> aiFuture;
     Point pendingAiMove;
+
+    // Pondering: one search per predicted reply, run while the user thinks
+    struct Ponder {
+        Point reply;
+        std::function<void()> abort;
+        std::future<Point> result;
+    };
+    std::vector<Ponder> ponders;
+    // Aborted ponder searches still winding down, dropped once finished
+    std::vector<std::future<Point>> retiredPonders;
     
     // Game over animation
     float gameOverAlpha = 0.0f;
@@ -273,6 +288,20 @@ private:
             drawText("You", panelX + 32, indicatorY + 30, 18, TEXT_COLOR);
         }
 
+        // Engine button: switches between alpha-beta and MCTS for the next AI move
+        Rectangle engineRect = {panelX, (float)WINDOW_HEIGHT - 150.0f, 150.0f, 45.0f};
+        bool engineHover = CheckCollisionPointRec(GetMousePosition(), engineRect);
+        const char* engineName = engine == Engine::MCTS ? "MCTS" : "Alpha-Beta";
+        Vector2 engineSize = MeasureTextEx(font, engineName, 20, 1.0f);
+
+        DrawRectangleRounded(engineRect, 0.3f, 8, engineHover ? BTN_HOVER : BTN_COLOR);
+        drawText(engineName, panelX + (150.0f - engineSize.x) / 2.0f, WINDOW_HEIGHT - 137, 20, TEXT_COLOR);
+
+        if (engineHover && !aiThinking && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
+            engine = engine == Engine::MCTS ? Engine::ALPHA_BETA : Engine::MCTS;
+            promotePonder(Point(-1, -1));
+        }
+
         // Restart button
         Rectangle btnRect = {panelX, (float)WINDOW_HEIGHT - 90.0f, 150.0f, 45.0f};
         bool btnHover = CheckCollisionPointRec(GetMousePosition(), btnRect);
@@ -310,7 +339,9 @@ private:
         if (aiThinking && aiFuture.valid()) {
             aiFuture.wait();
         }
-        board = Board();
+        promotePonder(Point(-1, -1));
+        retiredPonders.clear();
+        board = Board<BOARD_SIZE>();
         lastMove = Point(-1, -1);
         gameOver = false;
         aiThinking = false;
@@ -322,14 +353,80 @@ private:
     void startAiThinking() {
         aiThinking = true;
         aiThinkingTime = 0.0f;
-        // Copy board for thread safety
-        Board boardCopy = board;
-        aiFuture = std::async(std::launch::async, [this, boardCopy]() mutable {
-            AI aiCopy;
-            return aiCopy.getBestMove(boardCopy);
+        // Copy board for thread safety (trivially copyable: one memcpy, no allocation)
+        Board<BOARD_SIZE> boardCopy = board;
+        Engine selected = engine;
+        aiFuture = std::async(std::launch::async, [boardCopy, selected]() mutable {
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(SEARCH_TIME_MS);
+            if (selected == Engine::MCTS) {
+                MCTS<BOARD_SIZE> mctsCopy;
+                return mctsCopy.getBestMove(boardCopy, deadline);
+            }
+            AI<BOARD_SIZE> aiCopy;
+            aiCopy.setSolvedStore(SOLVED_PATH);
+            return aiCopy.getBestMove(boardCopy, deadline);
         });
     }
 
+    // Search the user's likeliest replies on their time, each with the normal
+    // time budget and its share of the cores. A correct prediction has a head
+    // start of the user's thinking time, so its move is often ready at once.
+    void startPondering() {
+        if (PONDER_MOVES <= 0) return;
+
+        int hardware = std::max(1, (int)std::thread::hardware_concurrency());
+        int threads = std::max(1, hardware / PONDER_MOVES);
+        auto replies = board.getSortedCandidates(Role::USER);
+
+        for (int i = 0; i < replies.size() && i < PONDER_MOVES; i++) {
+            Board<BOARD_SIZE> boardCopy = board;
+            boardCopy.makeMove(replies[i], Role::USER);
+            if (boardCopy.checkWinner(replies[i]) != Role::EMPTY || boardCopy.isFull()) continue;
+
+            Ponder ponder;
+            ponder.reply = Board<BOARD_SIZE>::toPoint(replies[i]);
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(SEARCH_TIME_MS);
+            if (engine == Engine::MCTS) {
+                auto mcts = std::make_shared<MCTS<BOARD_SIZE>>(threads);
+                ponder.abort = [mcts]() { mcts->abort(); };
+                ponder.result = std::async(std::launch::async, [mcts, boardCopy, deadline]() mutable {
+                    return mcts->getBestMove(boardCopy, deadline);
+                });
+            } else {
+                auto ponderAi = std::make_shared<AI<BOARD_SIZE>>(TT_SIZE_MB, threads);
+                ponderAi->setSolvedStore(SOLVED_PATH);
+                ponder.abort = [ponderAi]() { ponderAi->abort(); };
+                ponder.result = std::async(std::launch::async, [ponderAi, boardCopy, deadline]() mutable {
+                    return ponderAi->getBestMove(boardCopy, deadline);
+                });
+            }
+            ponders.push_back(std::move(ponder));
+        }
+    }
+
+    // Take over the ponder search of the reply the user played, if predicted,
+    // and abort the rest (Point(-1, -1) aborts all)
+    bool promotePonder(Point reply) {
+        bool promoted = false;
+        for (auto& ponder : ponders) {
+            if (!promoted && ponder.reply == reply) {
+                aiFuture = std::move(ponder.result);
+                promoted = true;
+            } else {
+                ponder.abort();
+                retiredPonders.push_back(std::move(ponder.result));
+            }
+        }
+        ponders.clear();
+        return promoted;
+    }
+
+    void dropRetiredPonders() {
+        retiredPonders.erase(std::remove_if(retiredPonders.begin(), retiredPonders.end(), [](std::future<Point>& result) {
+            return result.wait_for(std::chrono::milliseconds(0)) == std::future_status::ready;
+        }), retiredPonders.end());
+    }
+
     void checkAiResult() {
         if (!aiThinking || !aiFuture.valid()) return;
         
@@ -348,12 +445,14 @@ private:
                 message = "DRAW!";
                 gameOver = true;
                 gameOverTime = 0.0f;
+            } else {
+                startPondering();
             }
         }
     }
 
 public:
-    RaylibGame() : lastMove(-1, -1) { }
+    explicit RaylibGame(Engine engine = Engine::ALPHA_BETA) : engine(engine), lastMove(-1, -1) { }
 
     void run() {
         // Enable high-DPI support and anti-aliasing
@@ -369,12 +468,14 @@ public:
         while (!WindowShouldClose()) {
             // Check AI result (non-blocking)
             checkAiResult();
+            dropRetiredPonders();
 
             // Handle input
             if (!gameOver && !aiThinking) {
                 Point clicked = getClickedCell();
                 if (clicked.getX() >= 0 && board.makeMove(clicked, Role::USER)) {
                     lastMove = clicked;
+                    bool predicted = promotePonder(clicked);
 
                     if (board.checkWinner(clicked) == Role::USER) {
                         message = "VICTORY!";
@@ -384,6 +485,10 @@ public:
                         message = "DRAW!";
                         gameOver = true;
                         gameOverTime = 0.0f;
+                    } else if (predicted) {
+                        // Pondered reply: its search becomes the AI's move
+                        aiThinking = true;
+                        aiThinkingTime = 0.0f;
                     } else {
                         // Start AI thinking in background
                         startAiThinking();
@@ -405,13 +510,17 @@ public:
         if (aiThinking && aiFuture.valid()) {
             aiFuture.wait();
         }
+        promotePonder(Point(-1, -1));
+        retiredPonders.clear();
         UnloadFont(font);
         CloseWindow();
     }
 };
 
-int main() {
-    RaylibGame game;
+int main(int argc, char **argv) {
+    // --mcts starts with the Monte Carlo engine instead of the alpha-beta search
+    Engine engine = argc > 1 && std::string(argv[1]) == "--mcts" ? Engine::MCTS : Engine::ALPHA_BETA;
+    RaylibGame game(engine);
     game.run();
     return 0;
 }
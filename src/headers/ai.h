@@ -2,81 +2,819 @@
 #define GOMOKU_AI_H
 
 #include "board.h"
-#include <limits>
+#include "book.h"
+#include "solved.h"
+#include "tt.h"
+#include "vcf.h"
+#include "vct.h"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
+template <int N>
 class AI {
 private:
-    // Alpha-Beta Pruning
-    // AI:      MAX
-    // USER:    MIN
-    // alpha:   the lowest score AI can promise
-    // beta:    the highest score USER can promise
-    int minimax(Board &board, Role role, int depth, Point lastMove, int alpha, int beta) {
-        auto winner = board.checkWinner(lastMove);
-        
-        if (winner != Role::EMPTY)
-            return winner == Role::BOT ? PredefinedScore::WIN : PredefinedScore::LOSE;
-        if (depth == 0 || board.isFull())
-            return board.evaluate(Role::BOT);
-        
-        auto candidates = board.getSortedCandidates(role);
+    using Move = typename Board<N>::Move;
 
-        if (role == Role::BOT) {
-            // BOT: try to get the MAX score
-            for (auto &p : candidates) {
-                if (board.makeMove(p, role)) {
-                    int score = minimax(board, Role::USER, depth - 1, p, alpha, beta);
-                    board.undoMove(p);
+    using Clock = std::chrono::steady_clock;
 
-                    alpha = std::max(alpha, score);
-                    if (alpha >= beta) break;
+    // Beyond every reachable score, so that -INF and INF negate safely
+    static const int INF = PredefinedScore::WIN + 1;
+
+    // Killer moves: the last two moves that caused a beta cutoff at each ply
+    static const int KILLER_SLOTS = 2;
+
+    static int roleIndex(Role role) {
+        return role == Role::BOT ? 1 : 0;
+    }
+
+    static void moveToFront(MoveList<N> &moves, uint16_t move) {
+        auto found = std::find(moves.moves, moves.moves + moves.count, move);
+        if (found != moves.moves + moves.count)
+            std::rotate(moves.moves, found, found + 1);
+    }
+
+    // Young Brothers Wait split point: a PV node whose eldest child has been
+    // searched offers its younger brothers (moves[next...]) to idle threads.
+    // The window, best result and cutoff flag are shared by everyone working
+    // on it; a cutoff cancels every task below it.
+    struct SplitPoint {
+        const SplitPoint *parent = nullptr;
+        Board<N> board;
+        Role role = Role::EMPTY;
+        int depth = 0, ply = 0, beta = 0;
+        MoveList<N> moves;
+
+        std::atomic<int> next{0};
+        std::atomic<bool> cutoff{false};
+        // threads other than the owner inside a task, guarded by AI::poolLock
+        int working = 0;
+
+        // guarded by `lock`
+        std::mutex lock;
+        int alpha = 0, bestScore = 0, bestIndex = 0;
+        Move bestMove = Board<N>::NO_MOVE;
+
+        bool cancelled() const {
+            for (auto sp = this; sp; sp = sp->parent)
+                if (sp->cutoff.load(std::memory_order_relaxed))
+                    return true;
+            return false;
+        }
+    };
+
+    // One search thread: its own board copy, move ordering tables and abort
+    // flag. The transposition table, root restrictions, deadline and stop
+    // flag are shared through the owning AI.
+    class Searcher {
+    public:
+        AI &ai;
+        Board<N> board;
+
+        Move killers[MAX_SEARCH_DEPTH + 1][KILLER_SLOTS];
+        // History heuristic: cutoff counts per role and cell, weighted by depth^2
+        uint32_t history[2][N * N];
+
+        // The stop flag and (once `timed`) the deadline are checked every 1024
+        // nodes, a cutoff above the current YBW task on every node. Passing
+        // the deadline raises the stop flag for the other threads. Only the
+        // main searcher is ever `timed`, so its depth 1 always completes.
+        bool timed = false;
+        bool aborted = false;
+        uint64_t nodes = 0;
+        // root score of the last completed depth, from the BOT's side
+        int rootScore = 0;
+
+        // innermost split point this thread is running a task of
+        const SplitPoint *split = nullptr;
+        // split points opened by this thread, oldest first; guarded by AI::poolLock
+        std::vector<SplitPoint *> splits;
+
+        explicit Searcher(AI &owner) : ai(owner), killers{}, history{} { }
+
+        bool timeUp() {
+            if (aborted)
+                return true;
+
+            if ((++nodes & 1023) == 0) {
+                if (timed && Clock::now() >= ai.deadline)
+                    ai.stop = true;
+                if (ai.stop.load(std::memory_order_relaxed))
+                    aborted = true;
+            }
+            if (split && split->cancelled())
+                aborted = true;
+            return aborted;
+        }
+
+        // Start of a search on `root`: forget the killers, age the history of the last one
+        void reset(const Board<N> &root) {
+            board = root;
+            timed = aborted = false;
+            split = nullptr;
+            nodes = 0;
+            rootScore = 0;
+
+            for (auto &slots : killers)
+                for (auto &killer : slots)
+                    killer = Board<N>::NO_MOVE;
+            for (auto &counters : history)
+                for (auto &counter : counters)
+                    counter >>= 1;
+        }
+
+        void recordCutoff(Role role, int depth, int ply, Move move) {
+            history[roleIndex(role)][move] += static_cast<uint32_t>(depth * depth);
+
+            if (ply <= MAX_SEARCH_DEPTH && killers[ply][0] != move) {
+                killers[ply][1] = killers[ply][0];
+                killers[ply][0] = move;
+            }
+        }
+
+        // Forced moves first, from the board's threat index: if the opponent
+        // could complete a five, only its winning cells are worth searching.
+        // Otherwise the table's best move, then this ply's killers, then the
+        // heuristic order with the history counters breaking ties.
+        MoveList<N> getMoves(Role role, uint16_t hashMove, int ply) {
+            Role opponent = opponentOf(role);
+            if (board.hasThreat(opponent, Threat::FIVE))
+                return board.getThreatCells(opponent, Threat::FIVE);
+
+            auto moves = board.getSortedCandidates(role, history[roleIndex(role)]);
+            if (ply <= MAX_SEARCH_DEPTH)
+                for (int slot = KILLER_SLOTS - 1; slot >= 0; --slot)
+                    moveToFront(moves, killers[ply][slot]);
+            moveToFront(moves, hashMove);
+            return moves;
+        }
+
+        // Quiescence at the horizon: a four changes the evaluation by more than
+        // any quiet move, so only fours and the blocks they force are played
+        // out, for at most `depth` plies. Without a five to block, the side
+        // to move may stand pat on the static evaluation.
+        int quiesce(Role role, int depth, Move lastMove, int alpha, int beta) {
+            if (timeUp())
+                return 0;
+
+            if (board.checkWinner(lastMove) != Role::EMPTY)
+                return PredefinedScore::LOSE;
+            if (board.hasThreat(role, Threat::FIVE))
+                return PredefinedScore::WIN;
+
+            Role opponent = opponentOf(role);
+            int standPat = board.evaluate(Role::BOT);
+            if (role == Role::USER)
+                standPat = -standPat;
+
+            MoveList<N> moves;
+            auto fives = board.getThreatCells(opponent, Threat::FIVE);
+            if (fives.size() > 1)
+                return PredefinedScore::LOSE;
+            if (fives.size() == 1) {
+                // the block is forced: no standing pat
+                if (depth == 0)
+                    return standPat;
+                moves.push(fives[0]);
+            }
+            else {
+                // an open four with no five to answer it wins in two moves
+                if (board.hasThreat(role, Threat::OPEN_FOUR))
+                    return PredefinedScore::WIN;
+                if (standPat >= beta || depth == 0)
+                    return standPat;
+                if (board.hasThreat(role, Threat::FOUR))
+                    moves = board.getThreatCells(role, Threat::FOUR);
+                alpha = std::max(alpha, standPat);
+            }
+
+            int bestScore = fives.empty() ? standPat : -INF;
+            for (auto p : moves) {
+                board.makeMove(p, role);
+                int score = -quiesce(opponent, depth - 1, p, -beta, -alpha);
+                board.undoMove(p);
+
+                bestScore = std::max(bestScore, score);
+                alpha = std::max(alpha, score);
+                if (alpha >= beta)
+                    break;
+            }
+            return bestScore;
+        }
+
+        // Plies taken off the index-th move: none for the first moves, shallow
+        // nodes, threat moves, or under YBW, whose results must not depend on timing
+        int lateMoveReduction(Role role, int depth, int index, Move move) const {
+            if (ai.parallel == Parallel::YBW || depth < LMR_MIN_DEPTH || index < LMR_MIN_INDEX)
+                return 0;
+            if (board.getThreat(move, role) != Threat::NONE || board.getThreat(move, opponentOf(role)) != Threat::NONE)
+                return 0;
+            return ai.reductions[depth][index];
+        }
+
+        // Principal Variation Search (negamax form)
+        // Scores are seen from the side to move: WIN means `role` wins. The
+        // static evaluation stays BOT-centred and is negated on USER nodes.
+        // The first move gets the full (alpha, beta) window; every later move is
+        // only tested against a null window (alpha, alpha + 1) and searched again
+        // with the full window when it beats alpha. Late quiet moves are tested
+        // at reduced depth first and lose the reduction when they beat alpha.
+        // Fail-soft: the result may lie outside (alpha, beta), which the
+        // aspiration loop relies on. At depth 0 the quiescence search takes over.
+        int pvs(Role role, int depth, int ply, Move lastMove, int alpha, int beta) {
+            if (timeUp())
+                return 0;
+
+            // the opponent's last move completed a five
+            if (board.checkWinner(lastMove) != Role::EMPTY)
+                return PredefinedScore::LOSE;
+            // the side to move completes a five next
+            if (board.hasThreat(role, Threat::FIVE))
+                return PredefinedScore::WIN;
+            if (board.isFull()) {
+                int score = board.evaluate(Role::BOT);
+                return role == Role::BOT ? score : -score;
+            }
+            if (depth == 0)
+                return quiesce(role, QUIESCENCE_DEPTH, lastMove, alpha, beta);
+
+            // Transposition table: reuse a result searched at least as deep
+            uint64_t key = board.getHash(role);
+            uint16_t hashMove = TTEntry::NO_MOVE;
+            TTEntry entry;
+            if (ai.table.probe(key, entry)) {
+                hashMove = entry.move;
+                // YBW keeps results repeatable: a deeper entry would graft a
+                // value that depends on which thread stored it first
+                if (ai.parallel == Parallel::YBW ? entry.depth == depth : entry.depth >= depth) {
+                    if (entry.bound == Bound::EXACT)
+                        return entry.score;
+                    if (entry.bound == Bound::LOWER && entry.score >= beta)
+                        return entry.score;
+                    if (entry.bound == Bound::UPPER && entry.score <= alpha)
+                        return entry.score;
+                }
+            }
+
+            int alphaOrigin = alpha;
+            int bestScore = -INF;
+            Move bestMove = Board<N>::NO_MOVE;
+            Role opponent = opponentOf(role);
+            auto candidates = getMoves(role, hashMove, ply);
+
+            for (int i = 0; i < candidates.size(); ++i) {
+                Move p = candidates[i];
+                if (bestMove != Board<N>::NO_MOVE && ai.canSplit(depth, alphaOrigin, beta)) {
+                    searchSplit(role, depth, ply, candidates, i, alpha, beta, bestScore, bestMove);
+                    break;
+                }
+                int reduction = lateMoveReduction(role, depth, i, p);
+                if (!board.makeMove(p, role))
+                    continue;
+
+                int score;
+                if (bestMove == Board<N>::NO_MOVE) {
+                    score = -pvs(opponent, depth - 1, ply + 1, p, -beta, -alpha);
+                }
+                else {
+                    score = -pvs(opponent, depth - 1 - reduction, ply + 1, p, -alpha - 1, -alpha);
+                    if (reduction && score > alpha)
+                        score = -pvs(opponent, depth - 1, ply + 1, p, -alpha - 1, -alpha);
+                    if (score > alpha && score < beta)
+                        score = -pvs(opponent, depth - 1, ply + 1, p, -beta, -alpha);
+                }
+                board.undoMove(p);
+
+                if (score > bestScore || bestMove == Board<N>::NO_MOVE) {
+                    bestScore = score;
+                    bestMove = p;
+                }
+                alpha = std::max(alpha, score);
+                if (alpha >= beta) {
+                    recordCutoff(role, depth, ply, p);
+                    break;
+                }
+            }
+
+            // an interrupted subtree proves nothing
+            if (aborted)
+                return bestScore;
+
+            Bound bound = bestScore <= alphaOrigin ? Bound::UPPER
+                        : bestScore >= beta ? Bound::LOWER
+                        : Bound::EXACT;
+            ai.table.store(key, depth, bestScore, bound, bestMove);
+            return bestScore;
+        }
+
+        // Run tasks of `sp` until its moves are gone, it is cut off or the search stops
+        void runTasks(SplitPoint &sp) {
+            const SplitPoint *outer = split;
+            split = &sp;
+            Role opponent = opponentOf(sp.role);
+
+            int index;
+            while (!aborted && (index = sp.next.fetch_add(1)) < sp.moves.size()) {
+                Move p = sp.moves[index];
+
+                // an elder brother wins ties, so it only needs to reach alpha
+                int threshold;
+                {
+                    std::lock_guard<std::mutex> guard(sp.lock);
+                    threshold = index < sp.bestIndex ? sp.alpha - 1 : sp.alpha;
+                }
+
+                board.makeMove(p, sp.role);
+                int score = -pvs(opponent, sp.depth - 1, sp.ply + 1, p, -threshold - 1, -threshold);
+                if (score > threshold && score < sp.beta)
+                    score = -pvs(opponent, sp.depth - 1, sp.ply + 1, p, -sp.beta, -threshold);
+                board.undoMove(p);
+
+                if (aborted)
+                    break;
+
+                std::lock_guard<std::mutex> guard(sp.lock);
+                if (score > threshold && (score > sp.bestScore || (score == sp.bestScore && index < sp.bestIndex))) {
+                    sp.bestScore = score;
+                    sp.bestMove = p;
+                    sp.bestIndex = index;
+                    sp.alpha = std::max(sp.alpha, score);
+                }
+                if (sp.alpha >= sp.beta) {
+                    sp.cutoff = true;
+                    recordCutoff(sp.role, sp.depth, sp.ply, p);
                 }
             }
-            return alpha;
+
+            split = outer;
         }
-        else {
-            // USER: try to get the MIN score
-            for (auto &p : candidates) {
-                if (board.makeMove(p, role)) {
-                    int score = minimax(board, Role::BOT, depth - 1, p, alpha, beta);
-                    board.undoMove(p);
 
-                    beta = std::min(beta, score);
-                    if (alpha >= beta) break;
+        // Young Brothers Wait: the eldest child (moves[0]) is done, so open a
+        // split point over moves[first...] and work on it alongside whoever
+        // joins. Returns once every task has finished, with the node's alpha,
+        // best score and best move updated. The best move is the lowest
+        // index among equal scores, as in the serial search.
+        void searchSplit(Role role, int depth, int ply, const MoveList<N> &moves, int first,
+                         int &alpha, int beta, int &bestScore, Move &bestMove) {
+            SplitPoint sp;
+            sp.parent = split;
+            sp.board = board;
+            sp.role = role;
+            sp.depth = depth;
+            sp.ply = ply;
+            sp.beta = beta;
+            sp.moves = moves;
+            sp.next = first;
+            sp.alpha = alpha;
+            sp.bestScore = bestScore;
+            sp.bestMove = bestMove;
+            sp.bestIndex = 0;
+
+            {
+                std::lock_guard<std::mutex> guard(ai.poolLock);
+                splits.push_back(&sp);
+            }
+            ai.poolSignal.notify_all();
+
+            runTasks(sp);
+
+            // helpers never look at the clock: watch it while they finish
+            {
+                std::unique_lock<std::mutex> guard(ai.poolLock);
+                while (sp.working != 0) {
+                    if (!timed || ai.stop.load())
+                        ai.poolSignal.wait(guard);
+                    else if (ai.poolSignal.wait_until(guard, ai.deadline) == std::cv_status::timeout)
+                        ai.stop = true;
                 }
+                splits.pop_back();
             }
-            return beta;
+
+            // our own task may have been cancelled by the cutoff, which is a result
+            aborted = ai.stop.load() || (split && split->cancelled());
+            alpha = sp.alpha;
+            bestScore = sp.bestScore;
+            bestMove = sp.bestMove;
         }
-    }
 
-public:
-    Point getBestMove(Board &board) {
-        auto candidates = board.getSortedCandidates(Role::BOT);
-        Point bestMove;
-        int bestScore = std::numeric_limits<int>::min();
-        
-        for (auto &p : candidates) {
-            if (board.makeMove(p, Role::BOT)) {
-                int score = minimax(
-                    board,
-                    Role::USER,
-                    SEARCH_DEPTH - 1,
-                    p,
-                    std::numeric_limits<int>::min(),
-                    std::numeric_limits<int>::max()
-                );
-                
+        // PVS over the root moves inside (alpha, beta), `bestMove` first if given.
+        // Alpha is shared across the candidates, so after the first move the rest
+        // are only proven worse. Returns false when the search was interrupted.
+        bool searchRoot(int depth, int alpha, int beta, Move &bestMove, int &bestScore) {
+            auto candidates = getMoves(Role::BOT, bestMove, 0);
+            if (!ai.rootDefences.empty()) {
+                MoveList<N> defences;
+                for (auto p : candidates)
+                    if (std::find(ai.rootDefences.begin(), ai.rootDefences.end(), p) != ai.rootDefences.end())
+                        defences.push(p);
+                candidates = defences;
+            }
+
+            int alphaOrigin = alpha;
+            Move best = Board<N>::NO_MOVE;
+            bestScore = -INF;
+
+            for (int i = 0; i < candidates.size(); ++i) {
+                Move p = candidates[i];
+                if (best != Board<N>::NO_MOVE && ai.canSplit(depth, alphaOrigin, beta)) {
+                    searchSplit(Role::BOT, depth, 0, candidates, i, alpha, beta, bestScore, best);
+                    if (aborted)
+                        return false;
+                    break;
+                }
+                if (!board.makeMove(p, Role::BOT))
+                    continue;
+
+                int score;
+                if (best == Board<N>::NO_MOVE) {
+                    score = -pvs(Role::USER, depth - 1, 1, p, -beta, -alpha);
+                }
+                else {
+                    score = -pvs(Role::USER, depth - 1, 1, p, -alpha - 1, -alpha);
+                    if (score > alpha && score < beta)
+                        score = -pvs(Role::USER, depth - 1, 1, p, -beta, -alpha);
+                }
                 board.undoMove(p);
 
+                if (aborted)
+                    return false;
+
                 if (score > bestScore) {
                     bestScore = score;
-                    bestMove = p;
+                    best = p;
+                }
+                alpha = std::max(alpha, score);
+                if (alpha >= beta) break;
+            }
+
+            bestMove = best;
+            Bound bound = bestScore <= alphaOrigin ? Bound::UPPER
+                        : bestScore >= beta ? Bound::LOWER
+                        : Bound::EXACT;
+            ai.table.store(board.getHash(Role::BOT), depth, bestScore, bound, bestMove);
+            return true;
+        }
+
+        // Iterative deepening from `firstDepth`, each depth seeded with the
+        // previous best move. An iteration cut off by the deadline or the stop
+        // flag is discarded. The first iteration ignores the deadline.
+        // Later depths start with an aspiration window around the previous
+        // score and widen the failing side to infinity on a miss.
+        Move iterate(int firstDepth) {
+            Move bestMove = Board<N>::NO_MOVE;
+            int lastScore = 0;
+            for (int depth = firstDepth; depth <= MAX_SEARCH_DEPTH; ++depth) {
+                int alpha = -INF, beta = INF;
+                if (depth > firstDepth) {
+                    alpha = lastScore - ASPIRATION_WINDOW;
+                    beta = lastScore + ASPIRATION_WINDOW;
                 }
+
+                Move move;
+                int score;
+                bool completed;
+                while (true) {
+                    move = bestMove;
+                    completed = searchRoot(depth, alpha, beta, move, score);
+                    if (!completed)
+                        break;
+
+                    if (score <= alpha)
+                        alpha = -INF;
+                    else if (score >= beta)
+                        beta = INF;
+                    else
+                        break;
+                }
+                if (!completed)
+                    break;
+
+                bestMove = move;
+                lastScore = rootScore = score;
+                // decided: deeper search cannot change the outcome
+                if (score >= PredefinedScore::WIN || score <= PredefinedScore::LOSE)
+                    break;
+                if (ai.timedSearch && Clock::now() >= ai.deadline)
+                    break;
+                timed = ai.timedSearch && this == ai.searchers[0].get();
+            }
+            return bestMove;
+        }
+    };
+
+    TranspositionTable table;
+    VCF<N> vcf;
+    VCT<N> vct;
+    OpeningBook<N> book;
+    SolvedStore<N> solved;
+    // score of the last move returned, from the BOT's side
+    int lastScore = 0;
+
+    // searchers[0] runs on the calling thread, the rest are Lazy SMP helpers
+    std::vector<std::unique_ptr<Searcher>> searchers;
+
+    // Root moves that refute the opponent's VCF when it has one; empty when
+    // the root is unrestricted
+    MoveList<N> rootDefences;
+
+    Clock::time_point deadline;
+    bool timedSearch = false;
+    std::atomic<bool> stop{false};
+    // pending abort(): read after `stop` is reset, cleared when getBestMove returns
+    std::atomic<bool> cancelled{false};
+
+    Parallel parallel = SEARCH_PARALLEL;
+
+    // Late move reductions by remaining depth and move index, at most depth - 2
+    uint8_t reductions[MAX_SEARCH_DEPTH + 1][N * N];
+
+    // YBW thread pool: idle helpers sleep on `poolSignal` until a split point opens
+    std::mutex poolLock;
+    std::condition_variable poolSignal;
+
+    // Split at PV nodes deep enough to pay for the hand-off
+    bool canSplit(int depth, int alpha, int beta) const {
+        return parallel == Parallel::YBW && searchers.size() > 1
+            && depth >= YBW_MIN_DEPTH && beta - alpha > 1;
+    }
+
+    // Oldest open split point of any thread, the nearest to the root and so
+    // the largest piece of work; poolLock must be held
+    SplitPoint *findSplit() {
+        for (auto &searcher : searchers)
+            for (auto sp : searcher->splits)
+                if (sp->next.load() < sp->moves.size() && !sp->cancelled())
+                    return sp;
+        return nullptr;
+    }
+
+    // YBW helper: steal tasks from open split points until the search stops
+    void helpSplits(Searcher &self) {
+        std::unique_lock<std::mutex> guard(poolLock);
+        while (!stop) {
+            SplitPoint *sp = findSplit();
+            if (!sp) {
+                poolSignal.wait(guard);
+                continue;
+            }
+
+            ++sp->working;
+            guard.unlock();
+
+            self.board = sp->board;
+            self.aborted = false;
+            self.runTasks(*sp);
+
+            guard.lock();
+            --sp->working;
+            poolSignal.notify_all();
+        }
+    }
+
+    // A move that needs no search: a book move, a solved position's move,
+    // else a forced win, which is added to the solved positions
+    Move findKnownMove(Board<N> &board) {
+        Move move;
+        if (book.probe(board, move, lastScore))
+            return move;
+
+        Proof proof;
+        if (solved.probe(board, Role::BOT, proof, move) && board.isCellEmpty(move)) {
+            lastScore = proof == Proof::WIN ? PredefinedScore::WIN : PredefinedScore::LOSE;
+            return move;
+        }
+
+        move = findForcedWin(board);
+        if (move != Board<N>::NO_MOVE) {
+            lastScore = PredefinedScore::WIN;
+            solved.record(board, Role::BOT, Proof::WIN, move);
+        }
+        return move;
+    }
+
+    // A completed search that ended in a decided score proved it: keep the proof
+    void recordSolved(const Board<N> &board, Move move) {
+        if (lastScore >= INF || lastScore <= -INF)
+            return;
+        if (lastScore >= PredefinedScore::WIN)
+            solved.record(board, Role::BOT, Proof::WIN, move);
+        else if (lastScore <= PredefinedScore::LOSE)
+            solved.record(board, Role::BOT, Proof::LOSS, move);
+    }
+
+    // A move that wins without searching: our own five, the first four of a
+    // VCF, or else the first threat of a VCT
+    Move findForcedWin(Board<N> &board) {
+        if (board.hasThreat(Role::BOT, Threat::FIVE))
+            return board.getThreatCells(Role::BOT, Threat::FIVE)[0];
+
+        Move move = vcf.solve(board, Role::BOT);
+        return move != Board<N>::NO_MOVE ? move : vct.solve(board, Role::BOT);
+    }
+
+    // The opponent wins by continuous fours if we play a quiet move: keep the
+    // root moves after which that win is gone. If none is (or the checks are
+    // cut short), the search stays unrestricted.
+    void findDefences(Searcher &searcher) {
+        Board<N> &board = searcher.board;
+        rootDefences = MoveList<N>();
+        if (vcf.solve(board, Role::USER) == Board<N>::NO_MOVE)
+            return;
+
+        for (auto p : searcher.getMoves(Role::BOT, TTEntry::NO_MOVE, 0)) {
+            board.makeMove(p, Role::BOT);
+            bool refuted = vcf.solve(board, Role::USER) == Board<N>::NO_MOVE;
+            board.undoMove(p);
+
+            if (vcf.wasInterrupted()) {
+                rootDefences = MoveList<N>();
+                return;
             }
+            if (refuted)
+                rootDefences.push(p);
         }
-        
+    }
+
+    // Arm the stop flag and the deadline for the solvers and the search
+    void begin(bool timed, Clock::time_point until) {
+        timedSearch = timed;
+        deadline = until;
+        stop = false;
+        if (cancelled)
+            stop = true;
+
+        vcf.watch(&stop, timed ? &deadline : nullptr);
+        vct.watch(&stop, timed ? &deadline : nullptr);
+    }
+
+    // Point(-1, -1) when a stopped search has no move to play
+    Point finish(Move move) {
+        cancelled = false;
+        return move == Board<N>::NO_MOVE ? Point(-1, -1) : Board<N>::toPoint(move);
+    }
+
+    // Runs `mainSearch` on the calling thread with the helpers alongside.
+    // Lazy SMP: every helper runs its own iterative deepening over the same
+    // root, odd helpers one depth ahead, sharing nothing but the table. The
+    // main searcher's result is played; the helpers only fill the table with
+    // entries it can use.
+    // YBW: the helpers wait for split points opened by the main searcher
+    // (or by each other) and search the younger brothers there.
+    // Either way they are stopped as soon as the main searcher is done.
+    template <typename MainSearch>
+    Move search(const Board<N> &board, MainSearch mainSearch) {
+        table.newSearch();
+        for (auto &searcher : searchers)
+            searcher->reset(board);
+        findDefences(*searchers[0]);
+
+        std::vector<std::thread> helpers;
+        for (size_t i = 1; i < searchers.size(); ++i) {
+            if (parallel == Parallel::YBW)
+                helpers.emplace_back([this, i] { helpSplits(*searchers[i]); });
+            else
+                helpers.emplace_back([this, i] { searchers[i]->iterate(1 + static_cast<int>(i % 2)); });
+        }
+
+        Move bestMove = mainSearch(*searchers[0]);
+
+        {
+            std::lock_guard<std::mutex> guard(poolLock);
+            stop = true;
+        }
+        poolSignal.notify_all();
+        for (auto &helper : helpers)
+            helper.join();
         return bestMove;
     }
+
+public:
+    explicit AI(size_t tableMegabytes = TT_SIZE_MB, int threads = SEARCH_THREADS, Parallel mode = SEARCH_PARALLEL)
+        : table(tableMegabytes), parallel(mode) {
+        for (int depth = 0; depth <= MAX_SEARCH_DEPTH; ++depth)
+            for (int index = 0; index < N * N; ++index) {
+                int reduction = 0;
+                if (depth >= LMR_MIN_DEPTH && index >= LMR_MIN_INDEX)
+                    reduction = static_cast<int>(LMR_BASE + std::log(depth) * std::log(index) / LMR_DIVISOR);
+                reductions[depth][index] = static_cast<uint8_t>(std::max(0, std::min(reduction, depth - 2)));
+            }
+        setThreads(threads);
+        book.open(BOOK_PATH);
+    }
+
+    // Opening book consulted before every search; nullptr or a file that is
+    // not a book leaves the AI without one
+    bool setBook(const char *path) {
+        if (!path) {
+            book.close();
+            return false;
+        }
+        return book.open(path);
+    }
+
+    // Solved-position store, created if missing; none until this is called,
+    // and nullptr leaves the AI without one again
+    bool setSolvedStore(const char *path) {
+        if (!path) {
+            solved.close();
+            return false;
+        }
+        return solved.open(path);
+    }
+
+    // Lazy SMP or Young Brothers Wait; only between searches
+    void setParallel(Parallel mode) {
+        parallel = mode;
+    }
+
+    // Search threads including the calling one; 0 means one per hardware thread
+    void setThreads(int threads) {
+        if (threads <= 0)
+            threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+        searchers.clear();
+        for (int i = 0; i < threads; ++i)
+            searchers.emplace_back(new Searcher(*this));
+    }
+
+    int getThreads() const {
+        return static_cast<int>(searchers.size());
+    }
+
+    // Score of the last move returned, from the BOT's side: the book's, WIN or
+    // LOSE for a solved position or forced win, else the root score of the
+    // last completed depth (0 if the search completed none)
+    int getLastScore() const {
+        return lastScore;
+    }
+
+    // Nodes visited by all threads during the last search
+    uint64_t getNodeCount() const {
+        uint64_t total = 0;
+        for (auto &searcher : searchers)
+            total += searcher->nodes;
+        return total;
+    }
+
+    // Thread-safe: stops the running search, or else the next one
+    void abort() {
+        {
+            std::lock_guard<std::mutex> guard(poolLock);
+            cancelled = true;
+            stop = true;
+        }
+        poolSignal.notify_all();
+    }
+
+    // Threat-space search for `role`, who is to move: the first move of a
+    // forced win through threes and fours within `budget` nodes, or NO_MOVE
+    typename Board<N>::Move findVCT(Board<N> &board, Role role, long budget = VCT_NODE_BUDGET) {
+        vct.watch(nullptr, nullptr);
+        return vct.solve(board, role, budget);
+    }
+
+    // Fixed-depth search to SEARCH_DEPTH
+    Point getBestMove(Board<N> &board) {
+        begin(false, Clock::time_point());
+        Move known = findKnownMove(board);
+        if (known != Board<N>::NO_MOVE)
+            return finish(known);
+
+        Move bestMove = search(board, [this, &board](Searcher &main) {
+            TTEntry entry;
+            Move move = table.probe(board.getHash(Role::BOT), entry) ? static_cast<Move>(entry.move) : Board<N>::NO_MOVE;
+            int score;
+            if (!main.searchRoot(SEARCH_DEPTH, -INF, INF, move, score))
+                return Board<N>::NO_MOVE;
+            main.rootScore = score;
+            return move;
+        });
+        lastScore = searchers[0]->rootScore;
+        if (bestMove != Board<N>::NO_MOVE)
+            recordSolved(board, bestMove);
+        return finish(bestMove);
+    }
+
+    // Iterative deepening until `until`: depths 1, 2, 3... An iteration cut
+    // off by the deadline is discarded and the move of the last completed
+    // depth is played. Depth 1 always completes.
+    Point getBestMove(Board<N> &board, Clock::time_point until) {
+        begin(true, until);
+        Move known = findKnownMove(board);
+        if (known != Board<N>::NO_MOVE)
+            return finish(known);
+
+        Move bestMove = search(board, [](Searcher &main) { return main.iterate(1); });
+        lastScore = searchers[0]->rootScore;
+        if (bestMove != Board<N>::NO_MOVE)
+            recordSolved(board, bestMove);
+        return finish(bestMove);
+    }
 };
 
 #endif
@@ -2,166 +2,504 @@
 #define GOMOKU_BOARD_H
 
 #include "types.h"
+#include "pattern.h"
 #include <vector>
 #include <algorithm>
 #include <limits>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <utility>
 
 // Forward declaration
-class Board;
+template <int N> class Board;
 
 // Zero-copy line view with iterator support
+// A view is resolved once to (direction, line, bit offset) on the board's
+// bitboards, so reading a cell is a pair of bit tests.
+template <int N>
 class LineView {
 private:
-    const Board& board;
-    Point start;
-    Direction dir;
+    const Board<N>& board;
+    int direction;
+    int line;
+    int offset;
     int length;
 
 public:
     class Iterator {
     private:
-        const Board& board;
-        Point current;
-        Direction dir;
-        int remaining;
+        const LineView& view;
+        int index;
 
     public:
-        Iterator(const Board& b, Point p, Direction d, int r)
-            : board(b), current(p), dir(d), remaining(r) { }
+        Iterator(const LineView& v, int i) : view(v), index(i) { }
 
-        Role operator*() const;
+        Role operator*() const { return view.at(index); }
 
         Iterator& operator++() {
-            current = Point(current.getX() + dir.getX(), current.getY() + dir.getY());
-            --remaining;
+            ++index;
             return *this;
         }
 
-        bool operator!=(const Iterator&) const {
-            return remaining > 0;
+        bool operator!=(const Iterator& other) const {
+            return index != other.index;
         }
     };
 
-    LineView(const Board& b, Point start, Direction dir, int length = std::numeric_limits<int>::max())
-        : board(b), start(start), dir(dir), length(length) { }
+    LineView(const Board<N>& b, Point start, Direction dir, int length = std::numeric_limits<int>::max());
+    // whole line `line` of bitboard direction `direction`
+    LineView(const Board<N>& b, int direction, int line);
 
-    Iterator begin() const { return Iterator(board, start, dir, length); }
-    Iterator end() const { return Iterator(board, start, dir, 0); }
+    Iterator begin() const { return Iterator(*this, 0); }
+    Iterator end() const { return Iterator(*this, length); }
 
     // Random access support (compute on-the-fly, no memory allocation)
     Role at(int index) const;
-    int getActualLength() const;
+    int getActualLength() const { return length; }
 };
 
-// standard gomoku board
-class Board {
+// Packed move: the cell index x * N + y. One byte up to 15x15, two bytes for
+// larger boards; the all-ones value is reserved for "no move".
+template <int N>
+using PackedMove = typename std::conditional<(N * N < 255), uint8_t, uint16_t>::type;
+
+// Line geometry of an N x N board, generated at compile time.
+// Directions: horizontal, vertical, diagonal (↘), diagonal (↙). For every cell
+// and direction: the line through it and its bit inside that line, counted
+// from the line's first cell. Also the cell's index in the padded mailbox,
+// which has a one-cell sentinel border on every side.
+template <int N>
+struct LineGeometry {
+    static const int DIRECTION_COUNT = 4;
+    static const int LINE_COUNT = 2 * N - 1;
+    static const int STRIDE = N + 2;
+
+    uint8_t line[N * N][DIRECTION_COUNT];
+    uint8_t bit[N * N][DIRECTION_COUNT];
+    uint8_t length[DIRECTION_COUNT][LINE_COUNT];
+    int padded[N * N];
+    // inverse of `padded`, -1 on the sentinel border
+    int unpadded[STRIDE * STRIDE];
+    // mailbox offset of one step along each direction
+    int step[DIRECTION_COUNT];
+
+    constexpr LineGeometry()
+        : line{}, bit{}, length{}, padded{}, unpadded{}, step{1, STRIDE, STRIDE + 1, STRIDE - 1} {
+        for (int i = 0; i < STRIDE * STRIDE; ++i)
+            unpadded[i] = -1;
+
+        for (int x = 0; x < N; ++x) {
+            for (int y = 0; y < N; ++y) {
+                int cell = x * N + y;
+                line[cell][0] = x;
+                bit[cell][0] = y;
+                line[cell][1] = y;
+                bit[cell][1] = x;
+                line[cell][2] = x - y + N - 1;
+                bit[cell][2] = x < y ? x : y;
+                line[cell][3] = x + y;
+                bit[cell][3] = x < N - 1 - y ? x : N - 1 - y;
+                padded[cell] = (x + 1) * STRIDE + (y + 1);
+                unpadded[padded[cell]] = cell;
+            }
+        }
+
+        for (int l = 0; l < LINE_COUNT; ++l) {
+            int diagonal = N - (l < N - 1 ? N - 1 - l : l - (N - 1));
+            length[0][l] = l < N ? N : 0;
+            length[1][l] = l < N ? N : 0;
+            length[2][l] = diagonal;
+            length[3][l] = diagonal;
+        }
+    }
+};
+
+// Zobrist keys for every (side, cell) and for the BOT to move, generated at
+// compile time with splitmix64
+template <int N>
+struct ZobristTable {
+    uint64_t keys[2][N * N];
+    uint64_t botToMove;
+
+    constexpr ZobristTable() : keys{}, botToMove(0) {
+        uint64_t state = 0x2545F4914F6CDD1Dull;
+        for (auto &side : keys)
+            for (auto &key : side)
+                key = next(state);
+        botToMove = next(state);
+    }
+
+    static constexpr uint64_t next(uint64_t &state) {
+        state += 0x9E3779B97F4A7C15ull;
+        uint64_t z = state;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+};
+
+// Cells within SEARCH_RANGE (in both axes) of every cell, excluding the cell itself
+template <int N>
+struct NeighbourTable {
+    static const int MAX_NEIGHBOURS = (2 * SEARCH_RANGE + 1) * (2 * SEARCH_RANGE + 1) - 1;
+
+    int count[N * N];
+    PackedMove<N> cells[N * N][MAX_NEIGHBOURS];
+
+    constexpr NeighbourTable() : count{}, cells{} {
+        for (int x = 0; x < N; ++x) {
+            for (int y = 0; y < N; ++y) {
+                int cell = x * N + y;
+                for (int i = -SEARCH_RANGE; i <= SEARCH_RANGE; ++i) {
+                    for (int j = -SEARCH_RANGE; j <= SEARCH_RANGE; ++j) {
+                        int nx = x + i, ny = y + j;
+                        if ((i != 0 || j != 0) && nx >= 0 && nx < N && ny >= 0 && ny < N)
+                            cells[cell][count[cell]++] = static_cast<PackedMove<N>>(nx * N + ny);
+                    }
+                }
+            }
+        }
+    }
+};
+
+// Fixed-capacity move list, kept on the stack instead of the heap
+template <int N>
+struct MoveList {
+    PackedMove<N> moves[N * N];
+    int count = 0;
+
+    void push(PackedMove<N> move) { moves[count++] = move; }
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    PackedMove<N> operator[](int index) const { return moves[index]; }
+    const PackedMove<N> *begin() const { return moves; }
+    const PackedMove<N> *end() const { return moves + count; }
+};
+
+// N x N gomoku board (N = BOARD_SIZE for the standard game)
+//
+// Storage is flat and trivially copyable, so a snapshot is a single memcpy.
+// Stones live both in a padded mailbox (one byte per cell, walls around the
+// edge) and in per-side line bitboards.
+template <int N>
+class alignas(64) Board {
+    // one bit per cell along a line
+    static_assert(N >= 5 && N <= 31, "line bitboards hold at most 31 cells");
+
+public:
+    using Move = PackedMove<N>;
+
+    static const int SIZE = N;
+    static const int DIRECTION_COUNT = LineGeometry<N>::DIRECTION_COUNT;
+    static const int LINE_COUNT = LineGeometry<N>::LINE_COUNT;
+    static const int STRIDE = LineGeometry<N>::STRIDE;
+    static constexpr Move NO_MOVE = std::numeric_limits<Move>::max();
+
+    static constexpr LineGeometry<N> GEOMETRY{};
+    static constexpr ZobristTable<N> ZOBRIST{};
+    static constexpr NeighbourTable<N> NEIGHBOURS{};
+
+    static Move toMove(const Point &p) {
+        return static_cast<Move>(p.getX() * N + p.getY());
+    }
+
+    static Point toPoint(Move move) {
+        return Point(move / N, move % N);
+    }
+
+    // Line containing (x, y) in the given direction
+    static int lineIndex(int x, int y, int direction) {
+        return GEOMETRY.line[x * N + y][direction];
+    }
+
+    // Bit of (x, y) inside its line, counted from the line's first cell
+    static int lineBit(int x, int y, int direction) {
+        return GEOMETRY.bit[x * N + y][direction];
+    }
+
+    static int lineLength(int direction, int line) {
+        return GEOMETRY.length[direction][line];
+    }
+
+    // Direction index of a unit step, -1 if it is not one of the four line directions
+    static int directionIndex(const Direction &dir) {
+        if (dir.getX() == 0 && dir.getY() == 1) return 0;
+        if (dir.getX() == 1 && dir.getY() == 0) return 1;
+        if (dir.getX() == 1 && dir.getY() == 1) return 2;
+        if (dir.getX() == 1 && dir.getY() == -1) return 3;
+        return -1;
+    }
+
+    uint32_t getLineMask(Role role, int direction, int line) const {
+        return lines[roleIndex(role)][direction][line];
+    }
+
+    Role getLineCell(int direction, int line, int bit) const {
+        uint32_t mask = 1u << bit;
+        if (lines[0][direction][line] & mask) return Role::USER;
+        if (lines[1][direction][line] & mask) return Role::BOT;
+        return Role::EMPTY;
+    }
+
 private:
-    std::vector<std::vector<Role>> board;
+    // Mailbox value of the sentinel border; the other values are Role
+    static const uint8_t WALL = 3;
+
+    // Padded mailbox, indexed by GEOMETRY.padded
+    uint8_t cells[STRIDE * STRIDE];
+    // Per-side bitboards: [role][direction][line], one bit per cell along the line
+    uint32_t lines[2][DIRECTION_COUNT][LINE_COUNT];
+    int stoneCount;
+    // Zobrist key of the current position, maintained by makeMove/undoMove
+    uint64_t hash;
+    // Pattern score of every line per side, and their per-side sums
+    int lineScore[2][DIRECTION_COUNT][LINE_COUNT];
+    int totalScore[2];
+
+    // Candidate set: empty cells with at least one stone within SEARCH_RANGE.
+    // nearCount is the reference count of such stones per cell; the set is an
+    // unordered array with a slot index per cell (-1 when absent).
+    uint8_t nearCount[N * N];
+    int16_t candidateSlot[N * N];
+    Move candidateCells[N * N];
+    int candidateCount;
+
+    // Move-ordering cache, indexed by mailbox cell: the evaluatePoint term of
+    // each direction if role r played there. shapeDirty holds one bit per
+    // direction still to be recomputed; a move only dirties the cells within
+    // four steps of it along its four lines.
+    int shapeCache[STRIDE * STRIDE][DIRECTION_COUNT][2];
+    uint8_t shapeDirty[STRIDE * STRIDE];
+
+    // Threat index: the Threat of every empty cell per direction and side,
+    // its maximum over the directions, and per side and Threat level a bitset
+    // of the cells at exactly that level. Kept current by makeMove/undoMove.
+    static const int THREAT_LEVELS = static_cast<int>(Threat::FIVE) + 1;
+    static const int CELL_WORDS = (N * N + 63) / 64;
+
+    uint8_t directionThreat[N * N][DIRECTION_COUNT][2];
+    uint8_t cellThreat[N * N][2];
+    uint64_t threatCells[2][THREAT_LEVELS][CELL_WORDS];
+    int threatCount[2][THREAT_LEVELS];
+
+    static int roleIndex(Role role) {
+        return role == Role::USER ? 0 : 1;
+    }
 
-    bool isRangeValid(int x, int y) const {
-        return x >= 0 && x < BOARD_SIZE && y >= 0 && y < BOARD_SIZE;
+    // Raw stone placement: mailbox, bitboards and stone count
+    void placeStone(Move move, Role role) {
+        auto &own = lines[roleIndex(role)];
+        for (int d = 0; d < DIRECTION_COUNT; ++d)
+            own[d][GEOMETRY.line[move][d]] |= 1u << GEOMETRY.bit[move][d];
+        cells[GEOMETRY.padded[move]] = static_cast<uint8_t>(role);
+        ++stoneCount;
     }
 
-    bool isRangeValid(const Point &p) const {
-        return isRangeValid(p.getX(), p.getY());
+    void removeStone(Move move, Role role) {
+        auto &own = lines[roleIndex(role)];
+        for (int d = 0; d < DIRECTION_COUNT; ++d)
+            own[d][GEOMETRY.line[move][d]] &= ~(1u << GEOMETRY.bit[move][d]);
+        cells[GEOMETRY.padded[move]] = static_cast<uint8_t>(Role::EMPTY);
+        --stoneCount;
     }
 
-    int analyzeShape(int count, bool leftOpen, bool rightOpen, bool hasGap) const {
-        if (count >= 5)
-            return PredefinedScore::FIVE;
+    // Re-score the four lines through `move`; every other line is unchanged by a move there
+    void updateLineScores(Move move) {
+        for (int d = 0; d < DIRECTION_COUNT; ++d) {
+            int line = GEOMETRY.line[move][d];
+            int length = lineLength(d, line);
 
-        if (count == 4) {
-            if (leftOpen && rightOpen)
-                return hasGap ? PredefinedScore::RUSH_4 : PredefinedScore::LIVE_4;
-            if (leftOpen || rightOpen)
-                return PredefinedScore::RUSH_4;
-            else
-                return 0;
+            for (int r = 0; r < 2; ++r) {
+                int score = Pattern::scoreLine(lines[r][d][line], lines[1 - r][d][line], length);
+                totalScore[r] += score - lineScore[r][d][line];
+                lineScore[r][d][line] = score;
+            }
         }
+    }
+
+    void addCandidate(Move cell) {
+        candidateSlot[cell] = static_cast<int16_t>(candidateCount);
+        candidateCells[candidateCount++] = cell;
+    }
+
+    void removeCandidate(Move cell) {
+        int slot = candidateSlot[cell];
+        Move last = candidateCells[--candidateCount];
+        candidateCells[slot] = last;
+        candidateSlot[last] = static_cast<int16_t>(slot);
+        candidateSlot[cell] = -1;
+    }
+
+    // A stone arrived at `cell`: it leaves the set, and its empty neighbours join on first reference
+    void occupyCandidate(Move cell) {
+        if (candidateSlot[cell] >= 0)
+            removeCandidate(cell);
 
-        if (count == 3) {
-            if (leftOpen && rightOpen)
-                return hasGap ? (PredefinedScore::LIVE_3 * 9 / 10) : PredefinedScore::LIVE_3;
-            if (leftOpen || rightOpen)
-                return PredefinedScore::SLEEP_3;
-            else
-                return 0;
+        for (int i = 0; i < NEIGHBOURS.count[cell]; ++i) {
+            Move n = NEIGHBOURS.cells[cell][i];
+            if (nearCount[n]++ == 0 && candidateSlot[n] < 0 && isCellEmpty(n))
+                addCandidate(n);
         }
+    }
 
-        if (count == 2) {
-            if (leftOpen && rightOpen)
-                return PredefinedScore::LIVE_2;
-            if (leftOpen || rightOpen)
-                return PredefinedScore::SLEEP_2;
-            else
-                return 0;
+    // Reverse of occupyCandidate once the stone at `cell` is gone
+    void releaseCandidate(Move cell) {
+        for (int i = 0; i < NEIGHBOURS.count[cell]; ++i) {
+            Move n = NEIGHBOURS.cells[cell][i];
+            if (--nearCount[n] == 0 && candidateSlot[n] >= 0)
+                removeCandidate(n);
         }
 
-        return 0;
+        if (nearCount[cell] > 0)
+            addCandidate(cell);
     }
 
-    // TODO: test required
-    int analyzeLine(const LineView &line, const Role &role) const {
-        int score = 0;
-        int index = 0;
-        int length = line.getActualLength();
-
-        while (index < length)
-        {
-            if (line.at(index) == role) {
-                bool leftOpen = (index > 0 && line.at(index - 1) == Role::EMPTY);
-                bool rightOpen = false;
-                int count = 0;
-
-                while (index < length && line.at(index) == role) {
-                    ++index;
-                    ++count;
-                }
+    // evaluatePoint's term for one direction: the 9-cell window around the move,
+    // optionally with side `own`'s stone placed on the move first
+    int directionScore(Move move, int d, int own, bool place) const {
+        int line = GEOMETRY.line[move][d];
+        int bit = GEOMETRY.bit[move][d];
+
+        // clip the window (4 cells each way) to the board
+        int from = std::max(bit - 4, 0);
+        int to = std::min(bit + 4, lineLength(d, line) - 1);
+        int length = to - from + 1;
+        uint32_t window = (1u << length) - 1;
+
+        uint32_t stones = lines[own][d][line] | (place ? 1u << bit : 0u);
+        uint32_t mine = (stones >> from) & window;
+        uint32_t theirs = (lines[1 - own][d][line] >> from) & window;
+        return Pattern::scoreLine(mine, theirs, length) - Pattern::scoreLine(theirs, mine, length);
+    }
 
-                bool hasGap = false;
+    // Threat of `role` (0/1) on the empty cell `move` along direction d
+    Threat classifyThreat(Move move, int d, int own) const {
+        int line = GEOMETRY.line[move][d];
+        int bit = GEOMETRY.bit[move][d];
+
+        // 9-cell window centred on the move; shifting by 4 first keeps the
+        // cells before the start of the line addressable, as walls
+        uint64_t wall = ~(((uint64_t(1) << lineLength(d, line)) - 1) << 4);
+        uint32_t mine = static_cast<uint32_t>((uint64_t(lines[own][d][line]) << 4) >> bit) & 0x1FFu;
+        uint32_t blocked = static_cast<uint32_t>(((uint64_t(lines[1 - own][d][line]) << 4 | wall) >> bit) & 0x1FFu);
+        return Pattern::THREATS(mine, blocked);
+    }
 
-                if (index < length && line.at(index) == Role::EMPTY) {
-                    if (index + 1 < length && line.at(index + 1) == role) {
-                        hasGap = true;
-                        ++index;
-                        while (index < length && line.at(index) == role) {
-                            ++index;
-                            ++count;
-                        }
-                    }
+    void setCellThreat(Move move, int own, int level) {
+        int old = cellThreat[move][own];
+        if (old == level)
+            return;
+
+        uint64_t bit = uint64_t(1) << (move & 63);
+        if (old != 0) {
+            threatCells[own][old][move >> 6] &= ~bit;
+            --threatCount[own][old];
+        }
+        if (level != 0) {
+            threatCells[own][level][move >> 6] |= bit;
+            ++threatCount[own][level];
+        }
+        cellThreat[move][own] = static_cast<uint8_t>(level);
+    }
+
+    void updateThreat(Move move, int d) {
+        for (int own = 0; own < 2; ++own) {
+            directionThreat[move][d][own] = static_cast<uint8_t>(classifyThreat(move, d, own));
+
+            int level = 0;
+            for (int k = 0; k < DIRECTION_COUNT; ++k)
+                level = std::max(level, static_cast<int>(directionThreat[move][k][own]));
+            setCellThreat(move, own, level);
+        }
+    }
+
+    // After a stone arrived at or left `move`: walk both ways along each line
+    // until the wall, dirty the cached shapes and reclassify the empty cells'
+    // threats within four steps, then refresh the moved cell itself
+    void refreshAround(Move move) {
+        int origin = GEOMETRY.padded[move];
+
+        for (int d = 0; d < DIRECTION_COUNT; ++d) {
+            for (int step : {GEOMETRY.step[d], -GEOMETRY.step[d]}) {
+                int cell = origin;
+                for (int k = 0; k < 4; ++k) {
+                    cell += step;
+                    if (cells[cell] == WALL)
+                        break;
+                    shapeDirty[cell] |= static_cast<uint8_t>(1u << d);
+                    if (cells[cell] == static_cast<uint8_t>(Role::EMPTY))
+                        updateThreat(static_cast<Move>(GEOMETRY.unpadded[cell]), d);
                 }
+            }
+        }
 
-                rightOpen = (index < length && line.at(index) == Role::EMPTY);
-                score += analyzeShape(count, leftOpen, rightOpen, hasGap);
+        if (isCellEmpty(move)) {
+            for (int d = 0; d < DIRECTION_COUNT; ++d)
+                updateThreat(move, d);
+        } else {
+            std::fill(&directionThreat[move][0][0], &directionThreat[move][0][0] + DIRECTION_COUNT * 2, 0);
+            setCellThreat(move, 0, 0);
+            setCellThreat(move, 1, 0);
+        }
+    }
+
+    // Cached evaluatePoint of the move with `role`'s stone on it
+    int shapeScore(Move move, Role role) {
+        int cell = GEOMETRY.padded[move];
+        auto &cache = shapeCache[cell];
+
+        if (shapeDirty[cell]) {
+            for (int d = 0; d < DIRECTION_COUNT; ++d) {
+                if (shapeDirty[cell] & (1u << d)) {
+                    cache[d][0] = directionScore(move, d, 0, true);
+                    cache[d][1] = directionScore(move, d, 1, true);
+                }
             }
-            else ++index;
+            shapeDirty[cell] = 0;
         }
 
-        return score;
+        int r = roleIndex(role);
+        return cache[0][r] + cache[1][r] + cache[2][r] + cache[3][r];
     }
 
-public:
-    Board() {
-        board = std::vector<std::vector<Role>>(BOARD_SIZE, std::vector<Role>(BOARD_SIZE, Role::EMPTY));
+    bool isRangeValid(int x, int y) const {
+        return x >= 0 && x < N && y >= 0 && y < N;
     }
 
-    bool makeMove(const Point &p, Role role)
-    {
-        if (!isCellEmpty(p))
-            return false;
+    bool isRangeValid(const Point &p) const {
+        return isRangeValid(p.getX(), p.getY());
+    }
 
-        board[p.getX()][p.getY()] = role;
-        return true;
+public:
+    Board()
+        : cells{}, lines{}, stoneCount(0), hash(0), lineScore{}, totalScore{},
+          nearCount{}, candidateCells{}, candidateCount(0), shapeCache{},
+          directionThreat{}, cellThreat{}, threatCells{}, threatCount{} {
+        static_assert(std::is_trivially_copyable<Board>::value, "Board snapshots must be a plain memcpy");
+
+        for (int i = 0; i < STRIDE * STRIDE; ++i) {
+            int x = i / STRIDE, y = i % STRIDE;
+            if (x == 0 || y == 0 || x == STRIDE - 1 || y == STRIDE - 1)
+                cells[i] = WALL;
+        }
+        std::fill(std::begin(candidateSlot), std::end(candidateSlot), -1);
+        std::fill(std::begin(shapeDirty), std::end(shapeDirty), static_cast<uint8_t>(0x0F));
+    }
+
+    // Point interface: validates the coordinates (user input, UI)
+    bool makeMove(const Point &p, Role role) {
+        return isRangeValid(p) && makeMove(toMove(p), role);
     }
 
     void undoMove(const Point &p) {
-        board[p.getX()][p.getY()] = Role::EMPTY;
+        if (isRangeValid(p))
+            undoMove(toMove(p));
     }
 
     Role getCell(const Point &p) const {
-        return isRangeValid(p)
-            ? board[p.getX()][p.getY()]
-            : Role::EMPTY;
+        return isRangeValid(p) ? getCell(toMove(p)) : Role::EMPTY;
     }
 
     bool isCellEmpty(const Point &p) const {
@@ -169,181 +507,193 @@ public:
     }
 
     Role checkWinner(const Point &p) const {
-        int directions[4][2] = {{1, 0}, {0, 1}, {1, 1}, {1, -1}};
-        Role cell = getCell(p);
-
-        for (auto &direction : directions)
-        {
-            int count = 1;
-
-            // check positive direction
-            for (int i = 1; i < 5; ++i)
-            {
-                Point newP(p.getX() + direction[0] * i, p.getY() + direction[1] * i);
-                if (isRangeValid(newP) && getCell(newP) == cell)
-                    count++;
-                else
-                    break;
-                if (count >= 5)
-                    return cell;
-            }
+        return isRangeValid(p) ? checkWinner(toMove(p)) : Role::EMPTY;
+    }
 
-            // check negative direction
-            for (int i = 1; i < 5; ++i)
-            {
-                Point newP(p.getX() - direction[0] * i, p.getY() - direction[1] * i);
-                if (isRangeValid(newP) && getCell(newP) == cell)
-                    count++;
-                else
-                    break;
-                if (count >= 5)
-                    return cell;
-            }
+    // Move interface: packed moves are on the board by construction, no range checks
+    bool makeMove(Move move, Role role) {
+        if (!isCellEmpty(move))
+            return false;
+
+        placeStone(move, role);
+        hash ^= ZOBRIST.keys[roleIndex(role)][move];
+        updateLineScores(move);
+        occupyCandidate(move);
+        refreshAround(move);
+        return true;
+    }
+
+    void undoMove(Move move) {
+        Role role = getCell(move);
+        if (role == Role::EMPTY)
+            return;
+
+        removeStone(move, role);
+        hash ^= ZOBRIST.keys[roleIndex(role)][move];
+        updateLineScores(move);
+        releaseCandidate(move);
+        refreshAround(move);
+    }
+
+    Role getCell(Move move) const {
+        return static_cast<Role>(cells[GEOMETRY.padded[move]]);
+    }
+
+    bool isCellEmpty(Move move) const {
+        return cells[GEOMETRY.padded[move]] == static_cast<uint8_t>(Role::EMPTY);
+    }
+
+    Role checkWinner(Move move) const {
+        Role cell = getCell(move);
+        if (cell == Role::EMPTY)
+            return Role::EMPTY;
+
+        for (int d = 0; d < DIRECTION_COUNT; ++d) {
+            uint32_t m = lines[roleIndex(cell)][d][GEOMETRY.line[move][d]];
+            // bit i of `fives` marks five in a row starting at bit i
+            uint32_t fives = m & (m >> 1) & (m >> 2) & (m >> 3) & (m >> 4);
+            // keep only the fives covering the move
+            uint32_t covering = (0x1Fu << GEOMETRY.bit[move][d]) >> 4;
+            if (fives & covering)
+                return cell;
         }
 
         return Role::EMPTY;
     }
 
-    bool isFull() const {
-        for (int i = 0; i < BOARD_SIZE; ++i)
-            for (int j = 0; j < BOARD_SIZE; ++j)
-                if (board[i][j] == Role::EMPTY)
-                    return false;
-        return true;
+    // position identity: equal for equal stone sets, regardless of move order
+    uint64_t getHash() const {
+        return hash;
     }
 
-    // fast evaluate point
-    int evaluatePoint(const Point &p, const Role &role) const {
-        int score = 0;
-        int directions[4][2] = {{1, 0}, {0, 1}, {1, 1}, {1, -1}};
-        Role opponent = (role == Role::USER) ? Role::BOT : Role::USER;
+    // key of the position after `role` plays on the empty cell `move`, without playing it
+    uint64_t getHashAfter(Move move, Role role) const {
+        return hash ^ ZOBRIST.keys[roleIndex(role)][move];
+    }
+
+    // key of the side to move, for tables where it matters who moves next
+    static uint64_t sideKey(Role toMove) {
+        return toMove == Role::BOT ? ZOBRIST.botToMove : 0;
+    }
+
+    uint64_t getHash(Role toMove) const {
+        return hash ^ sideKey(toMove);
+    }
+
+    // Threat index queries, all O(1) except the cell listing
+    Threat getThreat(Move move, Role role) const {
+        return static_cast<Threat>(cellThreat[move][roleIndex(role)]);
+    }
+
+    // does `role` have any empty cell reaching at least `level`?
+    bool hasThreat(Role role, Threat level) const {
+        for (int l = std::max(static_cast<int>(level), 1); l < THREAT_LEVELS; ++l)
+            if (threatCount[roleIndex(role)][l] > 0)
+                return true;
+        return false;
+    }
 
-        for (auto &dir : directions) {
-            // find the start point of the line (extend 4 blocks in the negative direction)
-            int startX = p.getX() - dir[0] * 4;
-            int startY = p.getY() - dir[1] * 4;
-            
-            // ensure the start point is within the valid range
-            while (!isRangeValid(startX, startY)) {
-                startX += dir[0];
-                startY += dir[1];
+    // the empty cells where `role` reaches at least `level`
+    MoveList<N> getThreatCells(Role role, Threat level) const {
+        MoveList<N> result;
+        int own = roleIndex(role);
+
+        for (int w = 0; w < CELL_WORDS; ++w) {
+            uint64_t bits = 0;
+            for (int l = std::max(static_cast<int>(level), 1); l < THREAT_LEVELS; ++l)
+                bits |= threatCells[own][l][w];
+
+            while (bits) {
+                result.push(static_cast<Move>(w * 64 + __builtin_ctzll(bits)));
+                bits &= bits - 1;
             }
-            
-            LineView line(*this, Point(startX, startY), Direction(dir[0], dir[1]), 9);
-            score += analyzeLine(line, role);
-            score -= analyzeLine(line, opponent);
         }
-        
+        return result;
+    }
+
+    int getStoneCount() const {
+        return stoneCount;
+    }
+
+    bool isFull() const {
+        return stoneCount == N * N;
+    }
+
+    // fast evaluate point: table lookups over the 9-cell window around the move in each direction
+    int evaluatePoint(Move move, const Role &role) const {
+        int score = 0;
+        for (int d = 0; d < DIRECTION_COUNT; ++d)
+            score += directionScore(move, d, roleIndex(role), false);
         return score;
     }
 
-    std::vector<Point> getCandidates() const {
-        std::vector<Point> candidates;
-        std::vector<Point> occupiedPoints;
-        std::vector<std::vector<bool>> visited(BOARD_SIZE, std::vector<bool>(BOARD_SIZE, false));
+    // Allocation-free access to the incrementally maintained candidate set
+    int getCandidateCount() const {
+        return candidateCount;
+    }
+
+    Move getCandidate(int index) const {
+        return candidateCells[index];
+    }
+
+    MoveList<N> getCandidates() const {
+        MoveList<N> candidates;
 
-        for (int i = 0; i < BOARD_SIZE; ++i)
-            for (int j = 0; j < BOARD_SIZE; ++j)
-                if (board[i][j] != Role::EMPTY)
-                    occupiedPoints.push_back(Point(i, j));
-        
         // return center point if board is empty
-        if (occupiedPoints.empty()) {
-            candidates.push_back(Point(BOARD_SIZE / 2, BOARD_SIZE / 2));
+        if (stoneCount == 0) {
+            candidates.push(toMove(Point(N / 2, N / 2)));
             return candidates;
         }
 
-        for (auto &p : occupiedPoints) {
-            for (int i = -SEARCH_RANGE; i <= SEARCH_RANGE; ++i) {
-                for (int j = -SEARCH_RANGE; j <= SEARCH_RANGE; ++j) {
-                    Point newP(p.getX() + i, p.getY() + j);
-                    if (isRangeValid(newP) && !visited[newP.getX()][newP.getY()]) {
-                        visited[newP.getX()][newP.getY()] = true;
-                        if (isCellEmpty(newP))
-                            candidates.push_back(newP);
-                    }
-                }
-            }
-        }
-
+        for (int i = 0; i < candidateCount; ++i)
+            candidates.push(candidateCells[i]);
         return candidates;
     }
 
     // optimize: sort candidates by heuristic score
-    std::vector<Point> getSortedCandidates(Role role) {
+    // `history` (one counter per move, optional) breaks ties between equal scores
+    MoveList<N> getSortedCandidates(Role role, const uint32_t *history = nullptr) {
         auto candidates = getCandidates();
         Role opponent = (role == Role::USER) ? Role::BOT : Role::USER;
 
-        // Calculate the score for each candidate point
-        std::vector<std::pair<int, Point>> scoredMoves;
-        for (auto &p : candidates) {
-            // Evaluate the point
-            board[p.getX()][p.getY()] = role;
-            int attackScore = evaluatePoint(p, role);
-            board[p.getX()][p.getY()] = Role::EMPTY;
-
-            board[p.getX()][p.getY()] = opponent;
-            int defenseScore = evaluatePoint(p, opponent);
-            board[p.getX()][p.getY()] = Role::EMPTY;
-
-            scoredMoves.push_back({attackScore + defenseScore, p});
+        // Calculate the score for each candidate point (from the shape cache)
+        std::pair<int, Move> scoredMoves[N * N];
+        for (int i = 0; i < candidates.size(); ++i) {
+            Move p = candidates[i];
+            int attackScore = shapeScore(p, role);
+            int defenseScore = shapeScore(p, opponent);
+            scoredMoves[i] = {attackScore + defenseScore, p};
         }
-        
+
         // Sort the moves by score in descending order
-        sort(
-            scoredMoves.begin(),
-            scoredMoves.end(),
-            [](const auto &a, const auto &b) { return a.first > b.first; }
-        );
-        
-        std::vector<Point> sortedMoves;
-        for (auto &move : scoredMoves)
-            sortedMoves.push_back(move.second);
+        if (history) {
+            sort(
+                scoredMoves,
+                scoredMoves + candidates.size(),
+                [history](const auto &a, const auto &b) {
+                    return a.first != b.first ? a.first > b.first : history[a.second] > history[b.second];
+                }
+            );
+        }
+        else {
+            sort(
+                scoredMoves,
+                scoredMoves + candidates.size(),
+                [](const auto &a, const auto &b) { return a.first > b.first; }
+            );
+        }
+
+        MoveList<N> sortedMoves;
+        for (int i = 0; i < candidates.size(); ++i)
+            sortedMoves.push(scoredMoves[i].second);
         return sortedMoves;
     }
 
+    // O(1): the per-line pattern scores are kept up to date by makeMove/undoMove
     int evaluate(const Role &role) const {
-        int myScore = 0;
-        int opponentScore = 0;
         Role opponent = (role == Role::USER) ? Role::BOT : Role::USER;
-
-        // horizontal
-        for (int i = 0; i < BOARD_SIZE; ++i) {
-            LineView line(*this, Point(i, 0), Direction(0, 1));
-            myScore += analyzeLine(line, role);
-            opponentScore += analyzeLine(line, opponent);
-        }
-
-        // vertical
-        for (int j = 0; j < BOARD_SIZE; ++j) {
-            LineView line(*this, Point(0, j), Direction(1, 0));
-            myScore += analyzeLine(line, role);
-            opponentScore += analyzeLine(line, opponent);
-        }
-
-        // diagonal (↘)
-        for (int i = 0; i < BOARD_SIZE; ++i) {
-            LineView line(*this, Point(i, 0), Direction(1, 1));
-            myScore += analyzeLine(line, role);
-            opponentScore += analyzeLine(line, opponent);
-        }
-        for (int j = 1; j < BOARD_SIZE; ++j) {
-            LineView line(*this, Point(0, j), Direction(1, 1));
-            myScore += analyzeLine(line, role);
-            opponentScore += analyzeLine(line, opponent);
-        }
-
-        // diagonal (↙)
-        for (int i = 0; i < BOARD_SIZE; ++i) {
-            LineView line(*this, Point(i, BOARD_SIZE - 1), Direction(1, -1));
-            myScore += analyzeLine(line, role);
-            opponentScore += analyzeLine(line, opponent);
-        }
-        for (int j = 0; j < BOARD_SIZE - 1; ++j) {
-            LineView line(*this, Point(0, j), Direction(1, -1));
-            myScore += analyzeLine(line, role);
-            opponentScore += analyzeLine(line, opponent);
-        }
+        int myScore = totalScore[roleIndex(role)];
+        int opponentScore = totalScore[roleIndex(opponent)];
 
         // Score = Σ(My Patterns) - k × Σ(Opponent Patterns)
         return myScore - static_cast<int>(DEFENSE_WEIGHT * opponentScore);
@@ -351,27 +701,28 @@ public:
 };
 
 // LineView implementations
-inline Role LineView::Iterator::operator*() const {
-    return board.getCell(current);
+template <int N>
+LineView<N>::LineView(const Board<N>& b, Point start, Direction dir, int length)
+    : board(b), direction(Board<N>::directionIndex(dir)), line(0), offset(0), length(0) {
+    if (direction < 0 || start.getX() < 0 || start.getX() >= N ||
+        start.getY() < 0 || start.getY() >= N)
+        return;
+
+    line = Board<N>::lineIndex(start.getX(), start.getY(), direction);
+    offset = Board<N>::lineBit(start.getX(), start.getY(), direction);
+    this->length = std::min(length, Board<N>::lineLength(direction, line) - offset);
 }
 
-inline Role LineView::at(int index) const {
-    Point p(start.getX() + dir.getX() * index, start.getY() + dir.getY() * index);
-    return board.getCell(p);
-}
+template <int N>
+LineView<N>::LineView(const Board<N>& b, int direction, int line)
+    : board(b), direction(direction), line(line), offset(0),
+      length(Board<N>::lineLength(direction, line)) { }
 
-inline int LineView::getActualLength() const {
-    int count = 0;
-    Point p = start;
-    while (count < length && board.getCell(p) != Role::EMPTY || 
-           (p.getX() >= 0 && p.getX() < BOARD_SIZE && p.getY() >= 0 && p.getY() < BOARD_SIZE)) {
-        if (!(p.getX() >= 0 && p.getX() < BOARD_SIZE && p.getY() >= 0 && p.getY() < BOARD_SIZE))
-            break;
-        ++count;
-        if (count >= length) break;
-        p = Point(p.getX() + dir.getX(), p.getY() + dir.getY());
-    }
-    return count;
+template <int N>
+Role LineView<N>::at(int index) const {
+    if (index < 0 || index >= length)
+        return Role::EMPTY;
+    return board.getLineCell(direction, line, offset + index);
 }
 
 #endif
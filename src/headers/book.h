@@ -0,0 +1,158 @@
+#ifndef GOMOKU_BOOK_H
+#define GOMOKU_BOOK_H
+
+#include "board.h"
+#include "mapping.h"
+#include <algorithm>
+#include <cstring>
+#include <random>
+
+// Opening book for the BOT: a header followed by records sorted by canonical
+// position key, one record per book move (several moves of a position are
+// adjacent). Read straight from a memory-mapped file, so there is nothing to
+// parse at startup and a probe is a binary search. Written by bookgen.
+//
+// A position and its seven rotations and reflections share one entry: the
+// key is the smallest Zobrist hash over the eight symmetries, and moves are
+// stored in the coordinates of that symmetry. Fields are in native byte order.
+template <int N>
+class OpeningBook {
+public:
+    using Move = typename Board<N>::Move;
+
+    struct Header {
+        char magic[8];
+        uint32_t boardSize;
+        uint32_t count;
+    };
+
+    struct Record {
+        uint64_t key;
+        uint16_t move;
+        // relative frequency of the move among the position's records
+        uint16_t weight;
+        // search score from the BOT's side
+        int32_t score;
+    };
+
+    static constexpr char MAGIC[8] = "GMKBOOK";
+    static const int SYMMETRIES = 8;
+
+private:
+    MappedFile file;
+    const Record *records = nullptr;
+    size_t count = 0;
+    std::mt19937 random{std::random_device{}()};
+
+public:
+    // Symmetry s flips x (bit 0), flips y (bit 1), then swaps x and y (bit 2)
+    static Move transform(Move move, int symmetry) {
+        int x = move / N, y = move % N;
+        if (symmetry & 1) x = N - 1 - x;
+        if (symmetry & 2) y = N - 1 - y;
+        if (symmetry & 4) std::swap(x, y);
+        return static_cast<Move>(x * N + y);
+    }
+
+    static Move inverse(Move move, int symmetry) {
+        int x = move / N, y = move % N;
+        if (symmetry & 4) std::swap(x, y);
+        if (symmetry & 1) x = N - 1 - x;
+        if (symmetry & 2) y = N - 1 - y;
+        return static_cast<Move>(x * N + y);
+    }
+
+    // Smallest hash of the position over the eight symmetries, and the symmetry giving it
+    static uint64_t canonicalKey(const Board<N> &board, int &symmetry) {
+        uint64_t keys[SYMMETRIES] = {};
+        for (int cell = 0; cell < N * N; ++cell) {
+            Role role = board.getCell(static_cast<Move>(cell));
+            if (role == Role::EMPTY)
+                continue;
+
+            int side = role == Role::USER ? 0 : 1;
+            for (int s = 0; s < SYMMETRIES; ++s)
+                keys[s] ^= Board<N>::ZOBRIST.keys[side][transform(static_cast<Move>(cell), s)];
+        }
+
+        symmetry = 0;
+        for (int s = 1; s < SYMMETRIES; ++s)
+            if (keys[s] < keys[symmetry])
+                symmetry = s;
+        return keys[symmetry];
+    }
+
+    // False (and no book) unless `path` holds a book for this board size
+    bool open(const char *path) {
+        close();
+        if (!file.open(path))
+            return false;
+
+        Header header;
+        bool valid = file.size() >= sizeof(Header);
+        if (valid) {
+            std::memcpy(&header, file.data(), sizeof(Header));
+            valid = std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 && header.boardSize == N
+                 && file.size() >= sizeof(Header) + header.count * sizeof(Record);
+        }
+        if (!valid) {
+            close();
+            return false;
+        }
+
+        records = reinterpret_cast<const Record *>(file.data() + sizeof(Header));
+        count = header.count;
+        return true;
+    }
+
+    void close() {
+        file.close();
+        records = nullptr;
+        count = 0;
+    }
+
+    bool isOpen() const {
+        return records != nullptr;
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    // A book move for the BOT to move in `board`, drawn by weight, and its
+    // score; false when the position is not in the book
+    bool probe(const Board<N> &board, Move &move, int &score) {
+        if (!records)
+            return false;
+
+        int symmetry;
+        uint64_t key = canonicalKey(board, symmetry);
+        auto range = std::equal_range(records, records + count, Record{key, 0, 0, 0},
+                                      [](const Record &a, const Record &b) { return a.key < b.key; });
+
+        uint32_t total = 0;
+        for (auto r = range.first; r != range.second; ++r)
+            total += r->weight;
+        if (total == 0)
+            return false;
+
+        uint32_t pick = std::uniform_int_distribution<uint32_t>(0, total - 1)(random);
+        for (auto r = range.first; r != range.second; ++r) {
+            if (pick >= r->weight) {
+                pick -= r->weight;
+                continue;
+            }
+            if (r->move >= N * N)
+                return false;
+            move = inverse(static_cast<Move>(r->move), symmetry);
+            score = r->score;
+            return board.isCellEmpty(move);
+        }
+        return false;
+    }
+};
+
+template <int N>
+constexpr char OpeningBook<N>::MAGIC[8];
+
+#endif
@@ -0,0 +1,264 @@
+#ifndef GOMOKU_DFPN_H
+#define GOMOKU_DFPN_H
+
+#include "board.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Exact result for the side to move
+enum class Proof { WIN, LOSS, UNKNOWN };
+
+// Depth-first proof-number search (df-pn), for analysis rather than play
+//
+// Proves a win for one side, the attacker: it may pick among its best
+// DFPN_ATTACK_MOVES candidates, while every candidate cell of the defender is
+// a defence that has to be refuted, so a proof holds against any reply near
+// the stones. Nodes carry (phi, delta) from the side to move: phi is the
+// proof number of its win, delta the proof number of its loss, and the child
+// with the least delta is expanded until a threshold is crossed.
+//
+// (phi, delta) pairs live in a table of fixed size: four entries per bucket,
+// a new entry evicts the one with the smallest subtree, so the expensive
+// results survive once memory runs out. A full board or no reply left counts
+// as a failed attack.
+template <int N>
+class DFPN {
+public:
+    struct Result {
+        Proof proof = Proof::UNKNOWN;
+        // main line of the proof, side to move first; empty unless proven
+        std::vector<Point> line;
+        long nodes = 0;
+    };
+
+private:
+    using Move = typename Board<N>::Move;
+
+    static const uint32_t INF = 0xFFFFFFFFu;
+    static const int WAYS = 4;
+    // Zobrist key of the attacking side, mixed into the board hash
+    static const uint64_t BOT_ATTACKS = 0x6D1F3A9C52E8B047ull;
+
+    enum State { OPEN, WON, LOST };
+
+    struct Entry {
+        uint64_t key = 0;
+        uint32_t phi = 1;
+        uint32_t delta = 1;
+        // nodes spent below this entry; 0 marks an empty slot
+        uint32_t work = 0;
+    };
+
+    std::unique_ptr<Entry[]> table;
+    size_t mask = 0;
+
+    Role attacker = Role::BOT;
+    long nodes = 0;
+    long limit = 0;
+
+    uint64_t sideKey(Role mover) const {
+        return (attacker == Role::BOT ? BOT_ATTACKS : 0) ^ Board<N>::sideKey(mover);
+    }
+
+    // Unknown positions read as (1, 1)
+    Entry lookup(uint64_t key) const {
+        const Entry *bucket = &table[(key & mask) * WAYS];
+        for (int i = 0; i < WAYS; ++i)
+            if (bucket[i].work && bucket[i].key == key)
+                return bucket[i];
+
+        Entry fresh;
+        fresh.key = key;
+        return fresh;
+    }
+
+    void store(uint64_t key, uint32_t phi, uint32_t delta, uint32_t work) {
+        Entry *bucket = &table[(key & mask) * WAYS];
+        Entry *slot = &bucket[0];
+        for (int i = 0; i < WAYS; ++i) {
+            if (bucket[i].work && bucket[i].key == key) {
+                slot = &bucket[i];
+                break;
+            }
+            if (bucket[i].work < slot->work)
+                slot = &bucket[i];
+        }
+
+        slot->key = key;
+        slot->phi = phi;
+        slot->delta = delta;
+        slot->work = work ? work : 1;
+    }
+
+    // Moves of `mover`, unless the position is already decided for it
+    State expand(Board<N> &board, Role mover, MoveList<N> &moves) const {
+        Role other = opponentOf(mover);
+        if (board.hasThreat(mover, Threat::FIVE))
+            return WON;
+
+        auto fives = board.getThreatCells(other, Threat::FIVE);
+        if (fives.size() > 1)
+            return LOST;
+        if (fives.size() == 1) {
+            moves.push(fives[0]);
+            return OPEN;
+        }
+        if (board.hasThreat(mover, Threat::OPEN_FOUR))
+            return WON;
+
+        moves = board.getSortedCandidates(mover);
+        if (mover == attacker && moves.count > DFPN_ATTACK_MOVES)
+            moves.count = DFPN_ATTACK_MOVES;
+
+        // a draw is a successful defence
+        if (moves.empty())
+            return mover == attacker ? LOST : WON;
+        return OPEN;
+    }
+
+    // Search until phi >= thPhi or delta >= thDelta, or the budget runs out
+    void mid(Board<N> &board, Role mover, uint32_t thPhi, uint32_t thDelta) {
+        Role other = opponentOf(mover);
+        uint64_t key = board.getHash() ^ sideKey(mover);
+        long start = nodes++;
+        uint32_t work = lookup(key).work;
+
+        MoveList<N> moves;
+        State state = expand(board, mover, moves);
+        if (state != OPEN) {
+            store(key, state == WON ? 0 : INF, state == WON ? INF : 0, 1);
+            return;
+        }
+
+        uint32_t phi, delta;
+        while (true) {
+            // phi is the least delta of a child, delta the sum of the children's phi
+            uint32_t bestDelta = INF, secondDelta = INF, bestPhi = 0;
+            uint64_t sum = 0;
+            int best = 0;
+
+            for (int i = 0; i < moves.size(); ++i) {
+                Entry child = lookup(board.getHashAfter(moves[i], mover) ^ sideKey(other));
+                sum += child.phi;
+                if (child.delta < bestDelta) {
+                    secondDelta = bestDelta;
+                    bestDelta = child.delta;
+                    bestPhi = child.phi;
+                    best = i;
+                }
+                else if (child.delta < secondDelta) {
+                    secondDelta = child.delta;
+                }
+            }
+
+            phi = bestDelta;
+            delta = phi == 0 ? INF : static_cast<uint32_t>(std::min<uint64_t>(sum, INF - 1));
+            if (phi >= thPhi || delta >= thDelta || nodes >= limit)
+                break;
+
+            uint64_t childPhi = static_cast<uint64_t>(thDelta) + bestPhi - delta;
+            uint32_t childThPhi = static_cast<uint32_t>(std::min<uint64_t>(childPhi, INF));
+            uint32_t childThDelta = secondDelta == INF ? thPhi : std::min(thPhi, secondDelta + 1);
+
+            board.makeMove(moves[best], mover);
+            mid(board, other, childThPhi, childThDelta);
+            board.undoMove(moves[best]);
+        }
+
+        uint64_t total = static_cast<uint64_t>(work) + (nodes - start);
+        store(key, phi, delta, static_cast<uint32_t>(std::min<uint64_t>(total, INF)));
+    }
+
+    // Winner's quickest proven move, loser's longest resistance
+    void mainLine(const Board<N> &root, Role mover, std::vector<Point> &line) const {
+        Board<N> board = root;
+        while (static_cast<int>(line.size()) < N * N) {
+            MoveList<N> moves;
+            State state = expand(board, mover, moves);
+            if (state == LOST) {
+                // two fives against the mover: one block, then the other five
+                auto fives = board.getThreatCells(opponentOf(mover), Threat::FIVE);
+                if (fives.size() > 1) {
+                    line.push_back(Board<N>::toPoint(fives[0]));
+                    line.push_back(Board<N>::toPoint(fives[1]));
+                }
+                return;
+            }
+            if (state == WON) {
+                // finish the five, or the open four that makes two of them
+                Threat level = board.hasThreat(mover, Threat::FIVE) ? Threat::FIVE : Threat::OPEN_FOUR;
+                Move win = board.getThreatCells(mover, level)[0];
+                line.push_back(Board<N>::toPoint(win));
+                if (level == Threat::FIVE)
+                    return;
+                board.makeMove(win, mover);
+                mover = opponentOf(mover);
+                continue;
+            }
+
+            Role other = opponentOf(mover);
+            Entry node = lookup(board.getHash() ^ sideKey(mover));
+            if (node.phi != 0 && node.delta != 0)
+                return;
+
+            Move next = Board<N>::NO_MOVE;
+            uint32_t nextWork = 0;
+            for (auto move : moves) {
+                Entry child = lookup(board.getHashAfter(move, mover) ^ sideKey(other));
+                bool proven = node.phi == 0 ? child.delta == 0 : child.phi == 0;
+                if (!proven || !child.work)
+                    continue;
+                if (next == Board<N>::NO_MOVE || (node.phi == 0 ? child.work < nextWork : child.work > nextWork)) {
+                    next = move;
+                    nextWork = child.work;
+                }
+            }
+
+            // a proven child may have been evicted
+            if (next == Board<N>::NO_MOVE)
+                return;
+
+            line.push_back(Board<N>::toPoint(next));
+            board.makeMove(next, mover);
+            mover = other;
+        }
+    }
+
+public:
+    explicit DFPN(size_t tableMegabytes = DFPN_TABLE_MB) {
+        size_t buckets = 1;
+        while (buckets * 2 * WAYS * sizeof(Entry) <= tableMegabytes * 1024 * 1024)
+            buckets *= 2;
+
+        table.reset(new Entry[buckets * WAYS]);
+        mask = buckets - 1;
+    }
+
+    // Win or loss for `role`, who is to move, within `nodeBudget` nodes: half
+    // of it for a win, the rest for a win of the opponent. A failed proof is
+    // not a draw, so anything else is UNKNOWN.
+    Result solve(Board<N> &board, Role role, long nodeBudget = DFPN_NODE_BUDGET) {
+        Result result;
+        nodes = 0;
+
+        for (Role side : {role, opponentOf(role)}) {
+            attacker = side;
+            limit = side == role ? nodeBudget / 2 : nodeBudget;
+            mid(board, role, INF, INF);
+
+            Entry root = lookup(board.getHash() ^ sideKey(role));
+            bool proven = side == role ? root.phi == 0 : root.delta == 0;
+            if (proven) {
+                result.proof = side == role ? Proof::WIN : Proof::LOSS;
+                mainLine(board, role, result.line);
+                break;
+            }
+        }
+
+        result.nodes = nodes;
+        return result;
+    }
+};
+
+#endif
@@ -0,0 +1,208 @@
+#ifndef GOMOKU_MAPPING_H
+#define GOMOKU_MAPPING_H
+
+#include <cstddef>
+#include <cstdint>
+
+#ifdef _WIN32
+// keep GDI and USER out: their names clash with raylib's
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#define NOGDI
+#define NOUSER
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Read-only view of a whole file mapped into memory (mmap / MapViewOfFile).
+// Pages are read on first touch, so opening costs nothing whatever the file
+// size, and processes mapping the same file share one copy in the page cache.
+// The view covers the file as it was when opened; reopen to see appends.
+class MappedFile {
+private:
+    const uint8_t *bytes = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#endif
+
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    ~MappedFile() {
+        close();
+    }
+
+    // False for a missing or empty file
+    bool open(const char *path) {
+        close();
+#ifdef _WIN32
+        file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                           OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            return false;
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+            close();
+            return false;
+        }
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        const void *view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        if (!view) {
+            close();
+            return false;
+        }
+        bytes = static_cast<const uint8_t *>(view);
+        length = static_cast<size_t>(size.QuadPart);
+#else
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0)
+            return false;
+
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size == 0) {
+            ::close(fd);
+            return false;
+        }
+        void *view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        // the mapping keeps the file open
+        ::close(fd);
+        if (view == MAP_FAILED)
+            return false;
+        bytes = static_cast<const uint8_t *>(view);
+        length = static_cast<size_t>(info.st_size);
+#endif
+        return true;
+    }
+
+    void close() {
+#ifdef _WIN32
+        if (bytes)
+            UnmapViewOfFile(bytes);
+        if (mapping)
+            CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE)
+            CloseHandle(file);
+        mapping = nullptr;
+        file = INVALID_HANDLE_VALUE;
+#else
+        if (bytes)
+            munmap(const_cast<uint8_t *>(bytes), length);
+#endif
+        bytes = nullptr;
+        length = 0;
+    }
+
+    bool isOpen() const {
+        return bytes != nullptr;
+    }
+
+    const uint8_t *data() const {
+        return bytes;
+    }
+
+    size_t size() const {
+        return length;
+    }
+};
+
+// Positional writes to a file, created if missing. Writes show through every
+// mapping of the file at once, in this process and in others.
+class FileWriter {
+private:
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+#else
+    int fd = -1;
+#endif
+
+public:
+    FileWriter() = default;
+    FileWriter(const FileWriter &) = delete;
+    FileWriter &operator=(const FileWriter &) = delete;
+
+    ~FileWriter() {
+        close();
+    }
+
+    bool open(const char *path) {
+        close();
+#ifdef _WIN32
+        file = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                           OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        return file != INVALID_HANDLE_VALUE;
+#else
+        fd = ::open(path, O_RDWR | O_CREAT, 0644);
+        return fd >= 0;
+#endif
+    }
+
+    void close() {
+#ifdef _WIN32
+        if (file != INVALID_HANDLE_VALUE)
+            CloseHandle(file);
+        file = INVALID_HANDLE_VALUE;
+#else
+        if (fd >= 0)
+            ::close(fd);
+        fd = -1;
+#endif
+    }
+
+    bool isOpen() const {
+#ifdef _WIN32
+        return file != INVALID_HANDLE_VALUE;
+#else
+        return fd >= 0;
+#endif
+    }
+
+    size_t size() const {
+#ifdef _WIN32
+        LARGE_INTEGER size;
+        return GetFileSizeEx(file, &size) ? static_cast<size_t>(size.QuadPart) : 0;
+#else
+        struct stat info;
+        return fstat(fd, &info) == 0 ? static_cast<size_t>(info.st_size) : 0;
+#endif
+    }
+
+    // Grow the file with zeros to `length` bytes; not while it is mapped on Windows
+    bool extend(size_t length) {
+        if (size() >= length)
+            return true;
+#ifdef _WIN32
+        LARGE_INTEGER end;
+        end.QuadPart = static_cast<LONGLONG>(length);
+        return SetFilePointerEx(file, end, nullptr, FILE_BEGIN) && SetEndOfFile(file);
+#else
+        return ftruncate(fd, static_cast<off_t>(length)) == 0;
+#endif
+    }
+
+    bool write(size_t offset, const void *data, size_t length) {
+#ifdef _WIN32
+        OVERLAPPED position = {};
+        position.Offset = static_cast<DWORD>(offset);
+        position.OffsetHigh = static_cast<DWORD>(static_cast<uint64_t>(offset) >> 32);
+        DWORD written = 0;
+        return WriteFile(file, data, static_cast<DWORD>(length), &written, &position) && written == length;
+#else
+        return pwrite(fd, data, length, static_cast<off_t>(offset)) == static_cast<ssize_t>(length);
+#endif
+    }
+};
+
+#endif
@@ -0,0 +1,320 @@
+#ifndef GOMOKU_MCTS_H
+#define GOMOKU_MCTS_H
+
+#include "board.h"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// Monte Carlo Tree Search engine, an alternative to the alpha-beta AI
+//
+// UCT selection over a tree shared by all threads (tree parallelism). A node
+// is expanded on its second visit into the best MCTS_MAX_CHILDREN candidates,
+// or only the forced cells when a five is pending. Playouts continue with a
+// threat-aware rollout policy read from the board's threat index, and score
+// the position by the sign of the evaluation if nobody won within
+// MCTS_ROLLOUT_DEPTH moves. Nodes come from a fixed pool that is reset for
+// every search; once it is full the tree stops growing and playouts go on.
+template <int N>
+class MCTS {
+private:
+    using Move = typename Board<N>::Move;
+    using Clock = std::chrono::steady_clock;
+
+    static const uint32_t NO_NODE = 0xFFFFFFFFu;
+    enum : uint8_t { LEAF, EXPANDING, EXPANDED };
+
+    // Tree node of the move that led to it. `reward` counts half points for
+    // the side that played `move`: 2 per win, 1 per draw. Visits are counted
+    // on the way down and rewards on the way back, so a playout in flight
+    // scores as a loss: the virtual loss that spreads the threads over
+    // different lines.
+    struct Node {
+        std::atomic<uint32_t> visits{0};
+        std::atomic<uint32_t> reward{0};
+        std::atomic<uint8_t> state{LEAF};
+        // written before `state` becomes EXPANDED
+        uint32_t firstChild = 0;
+        uint16_t childCount = 0;
+        Move move = Board<N>::NO_MOVE;
+    };
+
+    // xorshift64*, one per thread
+    struct Random {
+        uint64_t state;
+
+        uint32_t next() {
+            state ^= state >> 12;
+            state ^= state << 25;
+            state ^= state >> 27;
+            return static_cast<uint32_t>((state * 0x2545F4914F6CDD1Dull) >> 32);
+        }
+
+        int below(int bound) {
+            return static_cast<int>(next() % static_cast<uint32_t>(bound));
+        }
+    };
+
+    std::unique_ptr<Node[]> pool;
+    std::atomic<uint32_t> poolUsed{0};
+    int threads = 1;
+
+    // state of the running search, read-only for the threads except the counters
+    Board<N> root;
+    Clock::time_point deadline;
+    bool timed = false;
+    uint32_t playoutLimit = 0;
+    std::atomic<uint32_t> playouts{0};
+    std::atomic<bool> stop{false};
+    // pending abort(), as in AI
+    std::atomic<bool> cancelled{false};
+
+    // `count` consecutive fresh nodes, or NO_NODE when the pool is full
+    uint32_t allocate(int count) {
+        uint32_t first = poolUsed.fetch_add(static_cast<uint32_t>(count));
+        if (first + static_cast<uint32_t>(count) > static_cast<uint32_t>(MCTS_POOL_NODES))
+            return NO_NODE;
+
+        for (uint32_t i = first; i < first + static_cast<uint32_t>(count); ++i) {
+            pool[i].visits.store(0, std::memory_order_relaxed);
+            pool[i].reward.store(0, std::memory_order_relaxed);
+            pool[i].state.store(LEAF, std::memory_order_relaxed);
+            pool[i].childCount = 0;
+        }
+        return first;
+    }
+
+    // Children of a node with `role` to move: a pending five decides them
+    static MoveList<N> childMoves(Board<N> &board, Role role) {
+        if (board.hasThreat(role, Threat::FIVE)) {
+            MoveList<N> win;
+            win.push(board.getThreatCells(role, Threat::FIVE)[0]);
+            return win;
+        }
+        if (board.hasThreat(opponentOf(role), Threat::FIVE))
+            return board.getThreatCells(opponentOf(role), Threat::FIVE);
+
+        auto moves = board.getSortedCandidates(role);
+        if (moves.count > MCTS_MAX_CHILDREN)
+            moves.count = MCTS_MAX_CHILDREN;
+        return moves;
+    }
+
+    // Only one thread expands a node; the others keep playing out below it
+    bool expand(Node &node, Board<N> &board, Role role) {
+        uint8_t expected = LEAF;
+        if (!node.state.compare_exchange_strong(expected, EXPANDING))
+            return false;
+
+        auto moves = childMoves(board, role);
+        uint32_t first = allocate(moves.size());
+        if (first != NO_NODE) {
+            for (int i = 0; i < moves.size(); ++i)
+                pool[first + i].move = moves[i];
+            node.firstChild = first;
+            node.childCount = static_cast<uint16_t>(moves.size());
+        }
+        node.state.store(EXPANDED, std::memory_order_release);
+        return true;
+    }
+
+    // UCT; unvisited children first, in heuristic order
+    uint32_t select(const Node &node) const {
+        double logVisits = std::log(static_cast<double>(node.visits.load(std::memory_order_relaxed)) + 1.0);
+        uint32_t best = node.firstChild;
+        double bestValue = -1.0;
+
+        for (uint32_t i = node.firstChild; i < node.firstChild + node.childCount; ++i) {
+            uint32_t visits = pool[i].visits.load(std::memory_order_relaxed);
+            if (visits == 0)
+                return i;
+
+            double value = pool[i].reward.load(std::memory_order_relaxed) / (2.0 * visits)
+                         + MCTS_EXPLORATION * std::sqrt(logVisits / visits);
+            if (value > bestValue) {
+                bestValue = value;
+                best = i;
+            }
+        }
+        return best;
+    }
+
+    // Rollout policy: complete a five, block one, make an open four, stop the
+    // opponent's, then a threat of our own half of the time, else any candidate
+    static Move rolloutMove(const Board<N> &board, Role role, Random &random) {
+        Role opponent = opponentOf(role);
+        for (auto level : {Threat::FIVE, Threat::OPEN_FOUR}) {
+            for (Role side : {role, opponent}) {
+                if (board.hasThreat(side, level)) {
+                    auto cells = board.getThreatCells(side, level);
+                    return cells[random.below(cells.size())];
+                }
+            }
+        }
+
+        if (board.hasThreat(role, Threat::THREE) && (random.next() & 1)) {
+            auto cells = board.getThreatCells(role, Threat::THREE);
+            return cells[random.below(cells.size())];
+        }
+        return board.getCandidate(random.below(board.getCandidateCount()));
+    }
+
+    // Winner of a random continuation with `role` to move (EMPTY for a draw)
+    static Role rollout(Board<N> &board, Role role, Random &random) {
+        for (int step = 0; step < MCTS_ROLLOUT_DEPTH; ++step) {
+            if (board.hasThreat(role, Threat::FIVE))
+                return role;
+            if (board.isFull())
+                return Role::EMPTY;
+
+            board.makeMove(rolloutMove(board, role, random), role);
+            role = opponentOf(role);
+        }
+
+        int score = board.evaluate(Role::BOT);
+        return score > 0 ? Role::BOT : score < 0 ? Role::USER : Role::EMPTY;
+    }
+
+    void playout(Random &random) {
+        Board<N> board = root;
+        uint32_t path[N * N + 1];
+        int length = 0;
+
+        uint32_t current = 0;
+        pool[current].visits.fetch_add(1, std::memory_order_relaxed);
+        path[length++] = current;
+
+        Role toMove = Role::BOT;
+        Role winner = Role::EMPTY;
+        bool finished = false;
+
+        while (true) {
+            Node &node = pool[current];
+            uint8_t state = node.state.load(std::memory_order_acquire);
+            if (state != EXPANDED) {
+                // expand on the second visit, else play out from here
+                if (state == LEAF && node.visits.load(std::memory_order_relaxed) > 1 && expand(node, board, toMove))
+                    continue;
+                break;
+            }
+            if (node.childCount == 0)
+                break;
+
+            current = select(node);
+            Node &child = pool[current];
+            child.visits.fetch_add(1, std::memory_order_relaxed);
+            path[length++] = current;
+
+            board.makeMove(child.move, toMove);
+            if (board.checkWinner(child.move) != Role::EMPTY) {
+                winner = toMove;
+                finished = true;
+                break;
+            }
+            if (board.isFull()) {
+                finished = true;
+                break;
+            }
+            toMove = opponentOf(toMove);
+        }
+
+        if (!finished)
+            winner = rollout(board, toMove, random);
+
+        // path[i] was played by the BOT for odd i, by the USER for even i
+        for (int i = 1; i < length; ++i) {
+            Role mover = (i & 1) ? Role::BOT : Role::USER;
+            uint32_t reward = winner == mover ? 2 : winner == Role::EMPTY ? 1 : 0;
+            pool[path[i]].reward.fetch_add(reward, std::memory_order_relaxed);
+        }
+    }
+
+    bool finished() {
+        if (stop.load(std::memory_order_relaxed))
+            return true;
+        uint32_t count = playouts.fetch_add(1, std::memory_order_relaxed);
+        if (timed ? ((count & 63) == 0 && Clock::now() >= deadline) : count >= playoutLimit)
+            stop = true;
+        return stop.load(std::memory_order_relaxed);
+    }
+
+    void work(uint64_t seed) {
+        Random random{seed | 1};
+        while (!finished())
+            playout(random);
+    }
+
+    // Grow a fresh tree from `board` on every thread until the budget is spent;
+    // the most visited root move is played, Point(-1, -1) if there is none
+    Point search(const Board<N> &board) {
+        playouts = 0;
+        if (board.hasThreat(Role::BOT, Threat::FIVE)) {
+            cancelled = false;
+            return Board<N>::toPoint(board.getThreatCells(Role::BOT, Threat::FIVE)[0]);
+        }
+
+        root = board;
+        poolUsed = 0;
+        stop = false;
+        if (cancelled)
+            stop = true;
+
+        allocate(1);
+        expand(pool[0], root, Role::BOT);
+
+        std::vector<std::thread> helpers;
+        for (int i = 1; i < threads; ++i)
+            helpers.emplace_back([this, i] { work(0x9E3779B97F4A7C15ull * (i + 1)); });
+        work(0x9E3779B97F4A7C15ull);
+        for (auto &helper : helpers)
+            helper.join();
+        cancelled = false;
+
+        const Node &top = pool[0];
+        uint32_t best = top.firstChild;
+        for (uint32_t i = top.firstChild; i < top.firstChild + top.childCount; ++i)
+            if (pool[i].visits.load() > pool[best].visits.load())
+                best = i;
+        return top.childCount ? Board<N>::toPoint(pool[best].move) : Point(-1, -1);
+    }
+
+public:
+    explicit MCTS(int threadCount = SEARCH_THREADS) : pool(new Node[MCTS_POOL_NODES]) {
+        setThreads(threadCount);
+    }
+
+    // Playout threads including the calling one; 0 means one per hardware thread
+    void setThreads(int threadCount) {
+        threads = threadCount > 0 ? threadCount : std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+
+    // Thread-safe, as AI::abort(); the most visited root move so far is played
+    void abort() {
+        cancelled = true;
+        stop = true;
+    }
+
+    // Playouts completed by the last search
+    uint32_t getPlayoutCount() const {
+        return playouts.load();
+    }
+
+    // Fixed budget of MCTS_PLAYOUTS playouts
+    Point getBestMove(Board<N> &board) {
+        timed = false;
+        playoutLimit = MCTS_PLAYOUTS;
+        return search(board);
+    }
+
+    // Playouts until `until`
+    Point getBestMove(Board<N> &board, Clock::time_point until) {
+        timed = true;
+        deadline = until;
+        return search(board);
+    }
+};
+
+#endif
@@ -0,0 +1,240 @@
+#ifndef GOMOKU_PATTERN_H
+#define GOMOKU_PATTERN_H
+
+#include "types.h"
+#include <algorithm>
+#include <cstdint>
+
+// Table-driven line pattern scoring
+//
+// A line (or a window of one) is encoded as two bitmasks over its cells:
+// `own` stones and `blocked` cells (opponent stones). Everything outside
+// `length` counts as blocked too. Blocked cells split the line into segments
+// of own/empty cells, and every segment is scored by a single lookup of
+// (length, own mask) in a table built once at startup.
+namespace Pattern {
+    // Segments up to this length are tabulated, longer ones are scored directly
+    const int MAX_TABLE_SEGMENT = 16;
+
+    // `count` stones in a group whose longest unbroken run is `longestRun`
+    constexpr int analyzeShape(int count, int longestRun, bool leftOpen, bool rightOpen, bool hasGap) {
+        if (longestRun >= 5)
+            return PredefinedScore::FIVE;
+
+        // a gapped group of four or more wins by filling the gap, whatever its ends
+        if (hasGap && count >= 4)
+            return PredefinedScore::RUSH_4;
+
+        if (count == 4) {
+            if (leftOpen && rightOpen)
+                return PredefinedScore::LIVE_4;
+            if (leftOpen || rightOpen)
+                return PredefinedScore::RUSH_4;
+            else
+                return 0;
+        }
+
+        if (count == 3) {
+            if (leftOpen && rightOpen)
+                return hasGap ? (PredefinedScore::LIVE_3 * 9 / 10) : PredefinedScore::LIVE_3;
+            if (leftOpen || rightOpen)
+                return PredefinedScore::SLEEP_3;
+            else
+                return 0;
+        }
+
+        if (count == 2) {
+            if (leftOpen && rightOpen)
+                return PredefinedScore::LIVE_2;
+            if (leftOpen || rightOpen)
+                return PredefinedScore::SLEEP_2;
+            else
+                return 0;
+        }
+
+        return 0;
+    }
+
+    // Reference classifier for one segment (no blocked cells inside).
+    // A group is a run of stones, extended across one single-cell gap into the
+    // next run. Its ends are open when the neighbouring cell lies inside the
+    // segment. Segments shorter than five can never hold a five and score 0.
+    constexpr int scoreSegment(uint32_t own, int length) {
+        if (length < 5)
+            return 0;
+
+        auto isOwn = [own](int i) { return ((own >> i) & 1u) != 0; };
+        int score = 0;
+        int index = 0;
+
+        while (index < length) {
+            if (!isOwn(index)) {
+                ++index;
+                continue;
+            }
+
+            bool leftOpen = index > 0;
+            int firstRun = 0;
+            while (index < length && isOwn(index)) {
+                ++index;
+                ++firstRun;
+            }
+
+            bool hasGap = false;
+            int secondRun = 0;
+            if (index + 1 < length && isOwn(index + 1)) {
+                hasGap = true;
+                ++index;
+                while (index < length && isOwn(index)) {
+                    ++index;
+                    ++secondRun;
+                }
+            }
+
+            bool rightOpen = index < length;
+            score += analyzeShape(firstRun + secondRun, std::max(firstRun, secondRun), leftOpen, rightOpen, hasGap);
+        }
+
+        return score;
+    }
+
+    // Classifier checks on segments written cell by cell, X for own stones
+    constexpr int scoreCells(const char *cells) {
+        uint32_t own = 0;
+        int length = 0;
+        for (; cells[length]; ++length)
+            if (cells[length] == 'X')
+                own |= 1u << length;
+        return scoreSegment(own, length);
+    }
+
+    static_assert(scoreCells("XXXXX") == PredefinedScore::FIVE, "five");
+    static_assert(scoreCells("XXXXX_X") == PredefinedScore::FIVE, "five with a stone past the gap");
+    static_assert(scoreCells("X_XXXXX") == PredefinedScore::FIVE, "five with a stone before the gap");
+    static_assert(scoreCells("_XXXX_") == PredefinedScore::LIVE_4, "open four");
+    static_assert(scoreCells("XXXX_") == PredefinedScore::RUSH_4, "four closed on the left");
+    static_assert(scoreCells("_XXXX") == PredefinedScore::RUSH_4, "four closed on the right");
+    static_assert(scoreCells("XX_XX") == PredefinedScore::RUSH_4, "gapped four, both ends closed");
+    static_assert(scoreCells("_XX_XX_") == PredefinedScore::RUSH_4, "gapped four, both ends open");
+    static_assert(scoreCells("XXX_XXX") == PredefinedScore::RUSH_4, "gapped group of six");
+    static_assert(scoreCells("_XXX_") == PredefinedScore::LIVE_3, "open three");
+    static_assert(scoreCells("_XX_X_") == PredefinedScore::LIVE_3 * 9 / 10, "gapped open three");
+    static_assert(scoreCells("XXX__") == PredefinedScore::SLEEP_3, "closed three");
+    static_assert(scoreCells("XXXX") == 0, "no room for a five");
+
+    // Scores of every segment up to MAX_TABLE_SEGMENT cells,
+    // indexed by (1 << length) | own so that all lengths share one array
+    class SegmentTable {
+    private:
+        int scores[2u << MAX_TABLE_SEGMENT];
+
+    public:
+        SegmentTable() {
+            for (int length = 0; length <= MAX_TABLE_SEGMENT; ++length)
+                for (uint32_t own = 0; own < (1u << length); ++own)
+                    scores[(1u << length) | own] = scoreSegment(own, length);
+        }
+
+        int operator()(uint32_t own, int length) const {
+            return length <= MAX_TABLE_SEGMENT
+                ? scores[(1u << length) | own]
+                : scoreSegment(own, length);
+        }
+    };
+
+    inline const SegmentTable SEGMENT_SCORES;
+
+    // Threat class of the centre of a 9-cell window once the own side plays it.
+    // Bit 4 is the centre; cells off the board count as blocked. A five must
+    // cover the centre, so the window holds every cell that matters:
+    //   FIVE       the stone completes five (or more) in a row
+    //   OPEN_FOUR  afterwards two or more empty cells would complete a five
+    //   FOUR       afterwards exactly one empty cell would complete a five
+    //   THREE      one more stone in the window makes an open four
+    // Lookups index by the two 8-bit masks without the centre, in base 3.
+    class ThreatTable {
+    private:
+        static const int CENTER = 4;
+
+        uint8_t classes[6561];
+        uint16_t ternary[256];
+
+        static bool hasFive(uint32_t own) {
+            for (int start = 0; start <= CENTER; ++start)
+                if (((own >> start) & 0x1Fu) == 0x1Fu)
+                    return true;
+            return false;
+        }
+
+        // empty cells that would complete a five through the centre
+        static int countWinCells(uint32_t own, uint32_t blocked) {
+            int count = 0;
+            for (int i = 0; i < 9; ++i)
+                if (!((own | blocked) >> i & 1u) && hasFive(own | 1u << i))
+                    ++count;
+            return count;
+        }
+
+        static Threat classify(uint32_t own, uint32_t blocked) {
+            if (hasFive(own))
+                return Threat::FIVE;
+
+            int wins = countWinCells(own, blocked);
+            if (wins >= 2)
+                return Threat::OPEN_FOUR;
+            if (wins == 1)
+                return Threat::FOUR;
+
+            for (int i = 0; i < 9; ++i)
+                if (!((own | blocked) >> i & 1u) && countWinCells(own | 1u << i, blocked) >= 2)
+                    return Threat::THREE;
+
+            return Threat::NONE;
+        }
+
+        static uint32_t withCenter(uint32_t eight) {
+            return (eight & 0x0Fu) | ((eight & 0xF0u) << 1);
+        }
+
+    public:
+        ThreatTable() : classes{}, ternary{} {
+            for (uint32_t mask = 0; mask < 256; ++mask)
+                for (int i = 7; i >= 0; --i)
+                    ternary[mask] = static_cast<uint16_t>(ternary[mask] * 3 + (mask >> i & 1u));
+
+            for (uint32_t own = 0; own < 256; ++own)
+                for (uint32_t blocked = 0; blocked < 256; ++blocked)
+                    if (!(own & blocked))
+                        classes[ternary[own] + 2 * ternary[blocked]] = static_cast<uint8_t>(
+                            classify(withCenter(own) | 1u << CENTER, withCenter(blocked)));
+        }
+
+        // `own` and `blocked` are 9-bit windows; the centre bit is ignored
+        Threat operator()(uint32_t own, uint32_t blocked) const {
+            uint32_t ownEight = (own & 0x0Fu) | ((own >> 1) & 0xF0u);
+            uint32_t blockedEight = (blocked & 0x0Fu) | ((blocked >> 1) & 0xF0u);
+            return static_cast<Threat>(classes[ternary[ownEight] + 2 * ternary[blockedEight]]);
+        }
+    };
+
+    inline const ThreatTable THREATS;
+
+    // Sum of the segment scores of a line of `length` cells
+    inline int scoreLine(uint32_t own, uint32_t blocked, int length) {
+        uint32_t open = ~blocked & ((1u << length) - 1);
+        int score = 0;
+
+        while (open) {
+            int start = __builtin_ctz(open);
+            int run = __builtin_ctz(~(open >> start));
+            uint32_t runMask = (1u << run) - 1;
+
+            score += SEGMENT_SCORES((own >> start) & runMask, run);
+            open &= ~(runMask << start);
+        }
+
+        return score;
+    }
+}
+
+#endif
@@ -0,0 +1,160 @@
+#ifndef GOMOKU_SOLVED_H
+#define GOMOKU_SOLVED_H
+
+#include "board.h"
+#include "book.h"
+#include "dfpn.h"
+#include "mapping.h"
+#include <cstring>
+
+// Persistent store of solved positions, shared by every engine that opens
+// the same file, across games and processes
+//
+// The file is a header and an open-addressing hash table of fixed capacity.
+// Entries are only ever added: a slot goes from zeros to its entry once and
+// is never changed again, so a store only grows more useful. Lookups read a
+// read-only mapping of the file; additions are positional writes, which show
+// through every mapping at once. Like the transposition table, a slot holds
+// its key XOR its data, so a slot torn by concurrent writers reads as a miss
+// rather than a wrong entry; such a race can lose an entry, never corrupt one.
+//
+// Keys are canonical under the eight board symmetries, as in the opening
+// book, with the side to move mixed in.
+template <int N>
+class SolvedStore {
+public:
+    using Move = typename Board<N>::Move;
+
+    struct Header {
+        char magic[8];
+        uint32_t boardSize;
+        // slots in the table, a power of two
+        uint32_t capacity;
+    };
+
+    static constexpr char MAGIC[8] = "GMKSOLV";
+
+private:
+    struct Slot {
+        uint64_t check;
+        // proof:8 | move:16, never zero in a used slot
+        uint64_t data;
+    };
+
+    // slots tried from the home slot before a lookup or addition gives up
+    static const int PROBES = 16;
+
+    MappedFile view;
+    FileWriter writer;
+    const Slot *slots = nullptr;
+    size_t mask = 0;
+
+    static uint64_t positionKey(const Board<N> &board, Role role, int &symmetry) {
+        return OpeningBook<N>::canonicalKey(board, symmetry) ^ Board<N>::sideKey(role);
+    }
+
+public:
+    // Maps `path`, first creating an empty store of `capacity` slots if the
+    // file does not exist; false if it cannot or holds something else
+    bool open(const char *path, uint32_t capacity = SOLVED_STORE_SLOTS) {
+        close();
+        if (!writer.open(path))
+            return false;
+
+        if (writer.size() == 0) {
+            Header header = {};
+            std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+            header.boardSize = N;
+            header.capacity = capacity;
+            if (!writer.write(0, &header, sizeof(Header))
+                || !writer.extend(sizeof(Header) + static_cast<size_t>(capacity) * sizeof(Slot))) {
+                close();
+                return false;
+            }
+        }
+
+        Header header;
+        bool valid = view.open(path) && view.size() >= sizeof(Header);
+        if (valid) {
+            std::memcpy(&header, view.data(), sizeof(Header));
+            valid = std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 && header.boardSize == N
+                 && header.capacity > 0 && (header.capacity & (header.capacity - 1)) == 0
+                 && view.size() >= sizeof(Header) + static_cast<size_t>(header.capacity) * sizeof(Slot);
+        }
+        if (!valid) {
+            close();
+            return false;
+        }
+
+        slots = reinterpret_cast<const Slot *>(view.data() + sizeof(Header));
+        mask = header.capacity - 1;
+        return true;
+    }
+
+    void close() {
+        view.close();
+        writer.close();
+        slots = nullptr;
+        mask = 0;
+    }
+
+    bool isOpen() const {
+        return slots != nullptr;
+    }
+
+    // The proven result for `role` to move in `board` and the move stored
+    // with it: the win, or for a loss just the move the recording search
+    // chose; false if not stored
+    bool probe(const Board<N> &board, Role role, Proof &proof, Move &move) const {
+        if (!slots)
+            return false;
+
+        int symmetry;
+        uint64_t key = positionKey(board, role, symmetry);
+        for (int i = 0; i < PROBES; ++i) {
+            const Slot &slot = slots[(key + i) & mask];
+            uint64_t data = slot.data;
+            if (data == 0)
+                return false;
+            if ((slot.check ^ data) != key)
+                continue;
+
+            Move stored = static_cast<Move>(data >> 8);
+            if (stored >= N * N)
+                return false;
+            proof = (data & 0xFF) == 1 ? Proof::WIN : Proof::LOSS;
+            move = OpeningBook<N>::inverse(stored, symmetry);
+            return true;
+        }
+        return false;
+    }
+
+    // Add a proven result; a position already stored keeps its entry
+    bool record(const Board<N> &board, Role role, Proof proof, Move move) {
+        if (!slots || proof == Proof::UNKNOWN || move >= N * N)
+            return false;
+
+        int symmetry;
+        uint64_t key = positionKey(board, role, symmetry);
+        uint64_t data = (proof == Proof::WIN ? 1 : 2) | static_cast<uint64_t>(OpeningBook<N>::transform(move, symmetry)) << 8;
+
+        for (int i = 0; i < PROBES; ++i) {
+            size_t index = (key + i) & mask;
+            const Slot &slot = slots[index];
+            if (slot.data != 0) {
+                if ((slot.check ^ slot.data) == key)
+                    return false;
+                continue;
+            }
+
+            Slot entry = {key ^ data, data};
+            return writer.write(sizeof(Header) + index * sizeof(Slot), &entry, sizeof(Slot));
+        }
+        return false;
+    }
+};
+
+template <int N>
+constexpr char SolvedStore<N>::MAGIC[8];
+
+#endif
@@ -0,0 +1,187 @@
+#ifndef GOMOKU_THREATS_H
+#define GOMOKU_THREATS_H
+
+#include "board.h"
+#include "tt.h"
+#include <atomic>
+#include <chrono>
+
+// Threat-sequence search, the common ground of the VCF and VCT solvers
+// The attacker may only play cells where it makes a threat of at least
+// WEAKEST (strongest first); the defender may only answer with the moves
+// that actually meet the threat:
+//   after a four   the single cell completing the five
+//   after a three  every cell that leaves the attacker no open four (these
+//                  are always cells where the attacker could make a four),
+//                  and every counter-four, which gains the defender a tempo
+// A pending four of the defender has to be blocked by a move that is itself
+// a threat. Works for either side; the attacker is the side to move.
+//
+// Results are cached in a table of their own. A win is final whatever the
+// depth left; a failure only holds for the depth it was searched with, and
+// nothing is stored once the node budget has run out. Every position the
+// attacker moves from and every cell the defender tries against a three
+// costs one node. A raised stop flag or a passed deadline (see watch())
+// ends the search like an exhausted budget.
+template <int N, Threat WEAKEST>
+class ThreatSearch {
+public:
+    using Move = typename Board<N>::Move;
+    using Clock = std::chrono::steady_clock;
+
+private:
+    static const int WIN_DEPTH = 127;
+
+    TranspositionTable table;
+    long budget = 0;
+
+    const std::atomic<bool> *stopFlag = nullptr;
+    const Clock::time_point *deadline = nullptr;
+    bool interrupted = false;
+
+    // Take one node off the budget; false once it has run out. The stop
+    // flag and the deadline are checked every 256 nodes and empty it.
+    bool spend() {
+        if (budget <= 0)
+            return false;
+
+        if ((--budget & 255) == 0) {
+            if ((stopFlag && stopFlag->load(std::memory_order_relaxed)) || (deadline && Clock::now() >= *deadline)) {
+                interrupted = true;
+                budget = 0;
+            }
+        }
+        return true;
+    }
+
+    // Threat moves of the attacker, strongest first
+    static MoveList<N> getThreatMoves(const Board<N> &board, Role attacker) {
+        MoveList<N> moves = board.getThreatCells(attacker, Threat::OPEN_FOUR);
+        auto cells = board.getThreatCells(attacker, WEAKEST);
+
+        for (int level = static_cast<int>(Threat::FOUR); level >= static_cast<int>(WEAKEST); --level)
+            for (auto p : cells)
+                if (board.getThreat(p, attacker) == static_cast<Threat>(level))
+                    moves.push(p);
+        return moves;
+    }
+
+    // Attacker to move with `depth` threats left; sets `winMove` on success
+    bool attack(Board<N> &board, Role attacker, int depth, Move &winMove) {
+        if (board.hasThreat(attacker, Threat::FIVE)) {
+            winMove = board.getThreatCells(attacker, Threat::FIVE)[0];
+            return true;
+        }
+
+        Role defender = opponentOf(attacker);
+        auto defenderFives = board.getThreatCells(defender, Threat::FIVE);
+        if (depth == 0 || defenderFives.size() > 1 || !spend())
+            return false;
+
+        uint64_t key = board.getHash(attacker);
+        TTEntry entry;
+        if (table.probe(key, entry)) {
+            if (entry.score == PredefinedScore::WIN) {
+                winMove = static_cast<Move>(entry.move);
+                return true;
+            }
+            if (entry.depth >= depth)
+                return false;
+        }
+
+        MoveList<N> moves;
+        if (defenderFives.size() == 1) {
+            if (board.getThreat(defenderFives[0], attacker) >= WEAKEST)
+                moves.push(defenderFives[0]);
+        }
+        else {
+            moves = getThreatMoves(board, attacker);
+        }
+
+        for (auto p : moves) {
+            board.makeMove(p, attacker);
+            bool won = defend(board, attacker, depth);
+            board.undoMove(p);
+
+            if (won) {
+                winMove = p;
+                table.store(key, WIN_DEPTH, PredefinedScore::WIN, Bound::EXACT, p);
+                return true;
+            }
+            if (budget <= 0)
+                break;
+        }
+
+        if (budget > 0)
+            table.store(key, depth, 0, Bound::UPPER, TTEntry::NO_MOVE);
+        return false;
+    }
+
+    // The attacker just made a threat: it wins if every defence loses
+    bool defend(Board<N> &board, Role attacker, int depth) {
+        Role defender = opponentOf(attacker);
+        auto fives = board.getThreatCells(attacker, Threat::FIVE);
+        if (fives.size() >= 2)
+            return true;
+
+        MoveList<N> defences;
+        if (fives.size() == 1) {
+            defences.push(fives[0]);
+        }
+        else {
+            defences = board.getThreatCells(defender, Threat::FOUR);
+
+            // a cell that breaks up a three is one where the attacker would make a four
+            for (auto p : board.getThreatCells(attacker, Threat::FOUR)) {
+                if (board.getThreat(p, defender) >= Threat::FOUR)
+                    continue;
+                if (!spend())
+                    return false;
+
+                board.makeMove(p, defender);
+                bool stopped = !board.hasThreat(attacker, Threat::OPEN_FOUR);
+                board.undoMove(p);
+                if (stopped)
+                    defences.push(p);
+            }
+        }
+
+        for (auto p : defences) {
+            board.makeMove(p, defender);
+            Move next;
+            bool won = attack(board, attacker, depth - 1, next);
+            board.undoMove(p);
+
+            if (!won)
+                return false;
+        }
+        return true;
+    }
+
+protected:
+    explicit ThreatSearch(size_t tableMegabytes) : table(tableMegabytes) { }
+
+    Move run(Board<N> &board, Role attacker, int depth, long nodeBudget) {
+        table.newSearch();
+        budget = nodeBudget;
+        interrupted = false;
+
+        Move winMove = Board<N>::NO_MOVE;
+        return attack(board, attacker, depth, winMove) ? winMove : Board<N>::NO_MOVE;
+    }
+
+public:
+    // Stop every later solve early once `flag` is raised or `until` has
+    // passed; either may be nullptr. Both must outlive the solves.
+    void watch(const std::atomic<bool> *flag, const Clock::time_point *until) {
+        stopFlag = flag;
+        deadline = until;
+    }
+
+    // Whether the last solve was cut short by the stop flag or the deadline
+    bool wasInterrupted() const {
+        return interrupted;
+    }
+};
+
+#endif
@@ -0,0 +1,148 @@
+#ifndef GOMOKU_TT_H
+#define GOMOKU_TT_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+
+// Score bound stored with a search result
+enum class Bound : uint8_t { NONE, EXACT, LOWER, UPPER };
+
+// Unpacked view of a transposition table slot
+struct TTEntry {
+    uint64_t key = 0;
+    int32_t score = 0;
+    uint16_t move = NO_MOVE;
+    int8_t depth = -1;
+    Bound bound = Bound::NONE;
+    uint8_t generation = 0;
+
+    static const uint16_t NO_MOVE = 0xFFFF;
+};
+
+// Fixed-size transposition table, safe to share between search threads
+// Two slots per bucket: slot 0 keeps the deepest result (or any result from
+// an older search), slot 1 always takes the newest one.
+//
+// Lock-free: a slot is two relaxed 64-bit atomics, the packed entry and the
+// key XOR that entry. A slot torn by concurrent writers fails the key check
+// on probe and reads as a miss, so no reader ever sees a mixed entry.
+class TranspositionTable {
+private:
+    // score:32 | move:16 | depth:8 | bound:2 | generation:6
+    static const int GENERATION_BITS = 6;
+    static const uint8_t GENERATION_MASK = (1 << GENERATION_BITS) - 1;
+
+    struct Slot {
+        std::atomic<uint64_t> check{0};
+        std::atomic<uint64_t> data{0};
+    };
+
+    struct Bucket {
+        Slot slots[2];
+    };
+
+    std::unique_ptr<Bucket[]> buckets;
+    size_t count = 0;
+    size_t mask = 0;
+    uint8_t generation = 0;
+
+    static uint64_t pack(const TTEntry &entry) {
+        return static_cast<uint64_t>(static_cast<uint32_t>(entry.score))
+             | static_cast<uint64_t>(entry.move) << 32
+             | static_cast<uint64_t>(static_cast<uint8_t>(entry.depth)) << 48
+             | static_cast<uint64_t>(entry.bound) << 56
+             | static_cast<uint64_t>(entry.generation & GENERATION_MASK) << 58;
+    }
+
+    static TTEntry unpack(uint64_t key, uint64_t data) {
+        TTEntry entry;
+        entry.key = key;
+        entry.score = static_cast<int32_t>(static_cast<uint32_t>(data));
+        entry.move = static_cast<uint16_t>(data >> 32);
+        entry.depth = static_cast<int8_t>(static_cast<uint8_t>(data >> 48));
+        entry.bound = static_cast<Bound>((data >> 56) & 3);
+        entry.generation = static_cast<uint8_t>(data >> 58);
+        return entry;
+    }
+
+    static TTEntry load(const Slot &slot) {
+        uint64_t data = slot.data.load(std::memory_order_relaxed);
+        uint64_t check = slot.check.load(std::memory_order_relaxed);
+        return unpack(check ^ data, data);
+    }
+
+    static void save(Slot &slot, const TTEntry &entry) {
+        uint64_t data = pack(entry);
+        slot.check.store(entry.key ^ data, std::memory_order_relaxed);
+        slot.data.store(data, std::memory_order_relaxed);
+    }
+
+public:
+    explicit TranspositionTable(size_t megabytes) {
+        resize(megabytes);
+    }
+
+    // Round the bucket count down to a power of two within the memory budget
+    void resize(size_t megabytes) {
+        size_t size = 1;
+        while (size * 2 * sizeof(Bucket) <= megabytes * 1024 * 1024)
+            size *= 2;
+
+        buckets.reset(new Bucket[size]);
+        count = size;
+        mask = size - 1;
+    }
+
+    // Not thread-safe: only between searches
+    void clear() {
+        for (size_t i = 0; i < count; ++i)
+            for (auto &slot : buckets[i].slots) {
+                slot.check.store(0, std::memory_order_relaxed);
+                slot.data.store(0, std::memory_order_relaxed);
+            }
+    }
+
+    // Called once per search so that stale deep entries become replaceable
+    void newSearch() {
+        generation = (generation + 1) & GENERATION_MASK;
+    }
+
+    bool probe(uint64_t key, TTEntry &entry) const {
+        const Bucket &bucket = buckets[key & mask];
+        for (const auto &slot : bucket.slots) {
+            TTEntry found = load(slot);
+            if (found.key == key && found.bound != Bound::NONE) {
+                entry = found;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void store(uint64_t key, int depth, int score, Bound bound, uint16_t move) {
+        Bucket &bucket = buckets[key & mask];
+        TTEntry deep = load(bucket.slots[0]);
+
+        TTEntry entry;
+        entry.key = key;
+        entry.score = score;
+        entry.move = move;
+        entry.depth = static_cast<int8_t>(depth);
+        entry.bound = bound;
+        entry.generation = generation;
+
+        if (deep.key == key || depth >= deep.depth || deep.generation != generation) {
+            // demote the deep entry of another position instead of dropping it
+            if (deep.key != key && deep.bound != Bound::NONE)
+                save(bucket.slots[1], deep);
+            save(bucket.slots[0], entry);
+        }
+        else {
+            save(bucket.slots[1], entry);
+        }
+    }
+};
+
+#endif
@@ -3,7 +3,60 @@
 
 const int BOARD_SIZE = 15;
 const int SEARCH_DEPTH = 5;
+// Iterative deepening (deadline mode): depth cap and the UIs' time per move
+const int MAX_SEARCH_DEPTH = 20;
+const int SEARCH_TIME_MS = 3000;
+// Half width of the aspiration window around the previous iteration's score
+const int ASPIRATION_WINDOW = 2000;
 const int SEARCH_RANGE = 2;
+// Transposition table memory per AI instance
+const int TT_SIZE_MB = 32;
+// Opening book every AI opens, if present (written by bookgen)
+const char *const BOOK_PATH = "book.bin";
+// Store of solved positions the UIs' AIs read before searching and add their
+// proofs to, created if missing; slots of a new store (16 bytes each)
+const char *const SOLVED_PATH = "solved.bin";
+const int SOLVED_STORE_SLOTS = 1 << 18;
+// Search threads per AI, the calling one included (0: one per hardware thread)
+const int SEARCH_THREADS = 0;
+// How the threads share the work: Lazy SMP (shared table only) or Young
+// Brothers Wait tree splitting, whose fixed-depth results repeat exactly
+enum class Parallel { LAZY_SMP, YBW };
+const Parallel SEARCH_PARALLEL = Parallel::LAZY_SMP;
+// YBW: least remaining depth at which a PV node hands out its younger brothers
+const int YBW_MIN_DEPTH = 3;
+// Late move reductions: from this remaining depth and move index on, quiet
+// moves are searched floor(LMR_BASE + ln(depth) * ln(index) / LMR_DIVISOR)
+// plies shallower, and again at full depth if they beat alpha (not in YBW mode)
+const int LMR_MIN_DEPTH = 3;
+const int LMR_MIN_INDEX = 3;
+const double LMR_BASE = 0.5;
+const double LMR_DIVISOR = 2.0;
+// Threat quiescence past the horizon: plies of fours and forced blocks
+const int QUIESCENCE_DEPTH = 8;
+// VCF solver run before every search: fours per line, node budget, table memory
+const int VCF_DEPTH = 20;
+const int VCF_NODE_BUDGET = 20000;
+const int VCF_TABLE_MB = 4;
+// VCT (threes and fours) tried after the VCF: threats per line, node budget, table memory
+const int VCT_DEPTH = 10;
+const int VCT_NODE_BUDGET = 10000;
+const int VCT_TABLE_MB = 4;
+// GUI pondering: the user's likeliest replies searched while they think (0: off)
+const int PONDER_MOVES = 3;
+// Engine the UIs play with (selected by the --mcts command-line flag)
+enum class Engine { ALPHA_BETA, MCTS };
+// MCTS engine: playouts per fixed-budget move, tree node pool, children per
+// node, rollout length before the evaluation decides, UCT exploration constant
+const int MCTS_PLAYOUTS = 20000;
+const int MCTS_POOL_NODES = 1 << 20;
+const int MCTS_MAX_CHILDREN = 12;
+const int MCTS_ROLLOUT_DEPTH = 40;
+const double MCTS_EXPLORATION = 1.0;
+// df-pn solver (analysis): node budget, table memory, attacker moves per node
+const long DFPN_NODE_BUDGET = 2000000;
+const int DFPN_TABLE_MB = 64;
+const int DFPN_ATTACK_MOVES = 10;
 // K-Value = Defense / Attack
 const double DEFENSE_WEIGHT = 1.2; 
 
@@ -22,6 +75,13 @@ namespace PredefinedScore {
 
 enum class Role { EMPTY, USER, BOT };
 
+inline Role opponentOf(Role role) {
+    return role == Role::USER ? Role::BOT : Role::USER;
+}
+
+// What a stone on an empty cell would make for its side, weakest first
+enum class Threat { NONE, THREE, FOUR, OPEN_FOUR, FIVE };
+
 class Point {
 private:
     int x, y;
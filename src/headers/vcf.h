@@ -0,0 +1,25 @@
+#ifndef GOMOKU_VCF_H
+#define GOMOKU_VCF_H
+
+#include "threats.h"
+
+// Victory by Continuous Fours
+// Every attacker move must make a four, so the defender's reply is forced:
+// the one cell that would complete the five. With a branching factor of a
+// few moves, sequences far longer than the main search depth resolve in
+// milliseconds. Works for either side; the attacker is the side to move.
+template <int N>
+class VCF : public ThreatSearch<N, Threat::FOUR> {
+public:
+    using Move = typename Board<N>::Move;
+
+    explicit VCF(size_t tableMegabytes = VCF_TABLE_MB) : ThreatSearch<N, Threat::FOUR>(tableMegabytes) { }
+
+    // First move of a win by continuous fours for `attacker`, who is to move,
+    // within `depth` fours and `nodeBudget` nodes; NO_MOVE if none was found
+    Move solve(Board<N> &board, Role attacker, int depth = VCF_DEPTH, long nodeBudget = VCF_NODE_BUDGET) {
+        return this->run(board, attacker, depth, nodeBudget);
+    }
+};
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef GOMOKU_VCT_H
+#define GOMOKU_VCT_H
+
+#include "threats.h"
+
+// Victory by Continuous Threats (threat-space search)
+// The attacker may make threes as well as fours, so a defender facing a
+// three has several answers and every one of them has to lose.
+template <int N>
+class VCT : public ThreatSearch<N, Threat::THREE> {
+public:
+    using Move = typename Board<N>::Move;
+
+    explicit VCT(size_t tableMegabytes = VCT_TABLE_MB) : ThreatSearch<N, Threat::THREE>(tableMegabytes) { }
+
+    // First move of a win by continuous threats for `attacker`, who is to
+    // move, within `depth` threats and `nodeBudget` nodes; NO_MOVE if none
+    Move solve(Board<N> &board, Role attacker, long nodeBudget = VCT_NODE_BUDGET, int depth = VCT_DEPTH) {
+        return this->run(board, attacker, depth, nodeBudget);
+    }
+};
+
+#endif